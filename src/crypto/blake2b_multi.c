@@ -0,0 +1,325 @@
+#include "hash.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Multi-buffer Blake2b. Every piece of state is stored as [word][lane], so the inner loops over the lanes
+ * are plain element-wise operations that the compiler turns into SIMD instructions (AVX2/AVX-512 when enabled). */
+
+#define BLAKE2B_BLOCK_LEN 128
+#define BLAKE2B_LANES 4
+
+static const uint64_t blake2b_multi_iv[8] = {
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+    0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+};
+
+static const unsigned char blake2b_multi_sigma[12][16] = {
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+    {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+    {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+    {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+    {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+    {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+    {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+    {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+    {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0},
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3}
+};
+
+#define ROTR64(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+
+#define G_LANES(a, b, c, d, x, y) \
+    for (int l = 0; l < lanes; l++) { \
+        v[a][l] = v[a][l] + v[b][l] + m[x][l]; \
+        v[d][l] = ROTR64(v[d][l] ^ v[a][l], 32); \
+        v[c][l] = v[c][l] + v[d][l]; \
+        v[b][l] = ROTR64(v[b][l] ^ v[c][l], 24); \
+        v[a][l] = v[a][l] + v[b][l] + m[y][l]; \
+        v[d][l] = ROTR64(v[d][l] ^ v[a][l], 16); \
+        v[c][l] = v[c][l] + v[d][l]; \
+        v[b][l] = ROTR64(v[b][l] ^ v[c][l], 63); \
+    }
+
+static inline uint64_t load64_le(const unsigned char *p) {
+    return (uint64_t) p[0] | (uint64_t) p[1] << 8 | (uint64_t) p[2] << 16 | (uint64_t) p[3] << 24 |
+           (uint64_t) p[4] << 32 | (uint64_t) p[5] << 40 | (uint64_t) p[6] << 48 | (uint64_t) p[7] << 56;
+}
+
+/// Compresses one 128-byte block in each of the lanes. All the lanes share the same counter and flags.
+/// \param h Chaining values of the lanes
+/// \param blocks One block per lane
+/// \param t Byte counter after this block
+/// \param f0 Last block flag
+/// \param f1 Last node flag (tree hashing)
+/// \param lanes Number of lanes (a compile-time constant at every call site, at most BLAKE2B_LANES)
+static inline __attribute__((always_inline)) void
+blake2b_multi_compress(uint64_t h[8][BLAKE2B_LANES], const unsigned char *blocks[], uint64_t t, uint64_t f0,
+                       uint64_t f1, const int lanes) {
+    uint64_t m[16][BLAKE2B_LANES];
+    uint64_t v[16][BLAKE2B_LANES];
+
+    for (int i = 0; i < 16; i++)
+        for (int l = 0; l < lanes; l++)
+            m[i][l] = load64_le(blocks[l] + i * 8);
+
+    for (int l = 0; l < lanes; l++) {
+        for (int i = 0; i < 8; i++) {
+            v[i][l] = h[i][l];
+            v[i + 8][l] = blake2b_multi_iv[i];
+        }
+        v[12][l] ^= t;
+        v[14][l] ^= f0;
+        v[15][l] ^= f1;
+    }
+
+    for (int r = 0; r < 12; r++) {
+        const unsigned char *s = blake2b_multi_sigma[r];
+        G_LANES(0, 4, 8, 12, s[0], s[1])
+        G_LANES(1, 5, 9, 13, s[2], s[3])
+        G_LANES(2, 6, 10, 14, s[4], s[5])
+        G_LANES(3, 7, 11, 15, s[6], s[7])
+        G_LANES(0, 5, 10, 15, s[8], s[9])
+        G_LANES(1, 6, 11, 12, s[10], s[11])
+        G_LANES(2, 7, 8, 13, s[12], s[13])
+        G_LANES(3, 4, 9, 14, s[14], s[15])
+    }
+
+    for (int i = 0; i < 8; i++)
+        for (int l = 0; l < lanes; l++)
+            h[i][l] ^= v[i][l] ^ v[i + 8][l];
+}
+
+/// Hashes equal-length inputs in lockstep
+/// \param hash_outputs One 32-byte output buffer per lane
+/// \param inputs One input per lane
+/// \param length Length of every input
+/// \param lanes Number of lanes (a compile-time constant at every call site, at most BLAKE2B_LANES)
+static inline __attribute__((always_inline)) void
+blake2b_256_multi_lanes(unsigned char *hash_outputs[], const unsigned char *inputs[], long length, const int lanes) {
+    uint64_t h[8][BLAKE2B_LANES];
+    const unsigned char *blocks[BLAKE2B_LANES];
+
+    /* Parameter block: 32-byte digest, no key, fanout 1, depth 1 */
+    for (int l = 0; l < lanes; l++) {
+        for (int i = 0; i < 8; i++)
+            h[i][l] = blake2b_multi_iv[i];
+        h[0][l] ^= 0x01010000ULL ^ SHA256_OUTPUT_LEN;
+    }
+
+    /* Every block except the last one */
+    uint64_t t = 0;
+    long offset = 0;
+    while (length - offset > BLAKE2B_BLOCK_LEN) {
+        for (int l = 0; l < lanes; l++)
+            blocks[l] = inputs[l] + offset;
+        t += BLAKE2B_BLOCK_LEN;
+        blake2b_multi_compress(h, blocks, t, 0, 0, lanes);
+        offset += BLAKE2B_BLOCK_LEN;
+    }
+
+    /* The last (possibly partial or empty) block is zero padded */
+    unsigned char last_blocks[BLAKE2B_LANES][BLAKE2B_BLOCK_LEN];
+    for (int l = 0; l < lanes; l++) {
+        memset(last_blocks[l], 0, BLAKE2B_BLOCK_LEN);
+        memcpy(last_blocks[l], inputs[l] + offset, length - offset);
+        blocks[l] = last_blocks[l];
+    }
+    t += length - offset;
+    blake2b_multi_compress(h, blocks, t, ~0ULL, 0, lanes);
+
+    for (int l = 0; l < lanes; l++)
+        for (int i = 0; i < SHA256_OUTPUT_LEN; i++)
+            hash_outputs[l][i] = (unsigned char) (h[i / 8][l] >> (8 * (i % 8)));
+}
+
+int blake2b_256_multi(unsigned char *hash_outputs[], const unsigned char *inputs[], long length, int lanes) {
+    /* The lockstep code is instantiated for groups of 4 lanes (one 256-bit vector per state word). Wider groups
+     * need more than the 16/32 available vector registers and end up slower than two groups of 4. */
+    for (int group = 0; group < lanes; group += BLAKE2B_LANES) {
+        const unsigned char *group_inputs[BLAKE2B_LANES];
+        unsigned char *group_outputs[BLAKE2B_LANES];
+        unsigned char scratch[BLAKE2B_LANES][SHA256_OUTPUT_LEN];
+        for (int l = 0; l < BLAKE2B_LANES; l++) {
+            /* Missing lanes of the last group hash a copy of its first input into a scratch buffer */
+            group_inputs[l] = inputs[group + l < lanes ? group + l : group];
+            group_outputs[l] = group + l < lanes ? hash_outputs[group + l] : scratch[l];
+        }
+        blake2b_256_multi_lanes(group_outputs, group_inputs, length, BLAKE2B_LANES);
+    }
+    return SHA256_OUTPUT_LEN;
+}
+
+
+/* Tree hashing: BLAKE2bp generalized to any fanout that is a multiple of the lane count. The message is split in
+ * 128-byte blocks dealt round-robin to the leaves (leaf j gets the blocks j, j + fanout, j + 2 fanout, ...). Each
+ * leaf is a Blake2b node of depth 0 with a 64-byte output, and the root (depth 1) hashes the concatenated leaf
+ * outputs. Groups of 4 leaves are hashed in lockstep on the SIMD lanes, and the groups are spread over threads.
+ * With fanout 4, the result is the reference BLAKE2bp. */
+
+#define BLAKE2B_TREE_INNER_LEN 64
+#define BLAKE2B_TREE_MAX_FANOUT 64
+#define BLAKE2B_TREE_MIN_THREAD_LEN (1L << 20) /* Smallest share of the message worth a thread */
+
+typedef struct blake2b_tree_job {
+    unsigned char (*leaf_outputs)[BLAKE2B_TREE_INNER_LEN]; /* One output per leaf */
+    const unsigned char *input; /* Message */
+    long length; /* Message's length */
+    int output_len; /* Length of the tree hash (part of the parameter block of every node) */
+    int fanout; /* Number of leaves */
+    int first_group; /* First group of leaves of this job */
+    int group_step; /* Distance between the groups of this job */
+} blake2b_tree_job_t;
+
+/// Returns the number of message bytes that belong to a leaf
+/// \param length Message's length
+/// \param fanout Number of leaves
+/// \param leaf Leaf number
+/// \return Number of bytes
+static long blake2b_tree_leaf_length(long length, int fanout, int leaf) {
+    long stripe = (long) fanout * BLAKE2B_BLOCK_LEN;
+    long rest = length % stripe - (long) leaf * BLAKE2B_BLOCK_LEN;
+    if (rest < 0)
+        rest = 0;
+    if (rest > BLAKE2B_BLOCK_LEN)
+        rest = BLAKE2B_BLOCK_LEN;
+    return length / stripe * BLAKE2B_BLOCK_LEN + rest;
+}
+
+/// Sets the chaining value of one lane from the parameter block of a tree node
+/// \param h Chaining values of the lanes
+/// \param lane Target lane
+/// \param output_len Length of the tree hash
+/// \param fanout Number of leaves
+/// \param node_offset Leaf number (0 for the root)
+/// \param node_depth 0 for the leaves, 1 for the root
+static void blake2b_tree_node_init(uint64_t h[8][BLAKE2B_LANES], int lane, int output_len, int fanout,
+                                   uint64_t node_offset, int node_depth) {
+    for (int i = 0; i < 8; i++)
+        h[i][lane] = blake2b_multi_iv[i];
+    h[0][lane] ^= (uint64_t) output_len | (uint64_t) fanout << 16 | 2ULL << 24; /* No key, depth 2, leaf length 0 */
+    h[1][lane] ^= node_offset;
+    h[2][lane] ^= (uint64_t) node_depth | (uint64_t) BLAKE2B_TREE_INNER_LEN << 8;
+}
+
+/// Hashes a group of BLAKE2B_LANES consecutive leaves
+/// \param leaf_outputs Outputs of all the leaves
+/// \param input Message
+/// \param length Message's length
+/// \param output_len Length of the tree hash
+/// \param fanout Number of leaves
+/// \param first_leaf First leaf of the group
+static void blake2b_tree_leaf_group(unsigned char (*leaf_outputs)[BLAKE2B_TREE_INNER_LEN], const unsigned char *input,
+                                    long length, int output_len, int fanout, int first_leaf) {
+    uint64_t h[8][BLAKE2B_LANES];
+    const unsigned char *blocks[BLAKE2B_LANES];
+    long leaf_lengths[BLAKE2B_LANES];
+    long stripe = (long) fanout * BLAKE2B_BLOCK_LEN;
+
+    /* Every leaf keeps its last block for the finalization. The blocks before it are hashed in lockstep as long
+     * as all the leaves of the group have one. */
+    long lockstep_blocks = -1;
+    for (int l = 0; l < BLAKE2B_LANES; l++) {
+        blake2b_tree_node_init(h, l, output_len, fanout, first_leaf + l, 0);
+        leaf_lengths[l] = blake2b_tree_leaf_length(length, fanout, first_leaf + l);
+        long blocks_before_last = leaf_lengths[l] ? (leaf_lengths[l] - 1) / BLAKE2B_BLOCK_LEN : 0;
+        if (lockstep_blocks < 0 || blocks_before_last < lockstep_blocks)
+            lockstep_blocks = blocks_before_last;
+    }
+
+    for (long b = 0; b < lockstep_blocks; b++) {
+        for (int l = 0; l < BLAKE2B_LANES; l++)
+            blocks[l] = input + b * stripe + (long) (first_leaf + l) * BLAKE2B_BLOCK_LEN;
+        blake2b_multi_compress(h, blocks, (b + 1) * BLAKE2B_BLOCK_LEN, 0, 0, BLAKE2B_LANES);
+    }
+
+    /* The rest of each leaf (at most one more block and the last block) */
+    for (int l = 0; l < BLAKE2B_LANES; l++) {
+        int leaf = first_leaf + l;
+        uint64_t lane_h[8][BLAKE2B_LANES];
+        for (int i = 0; i < 8; i++)
+            lane_h[i][0] = h[i][l];
+
+        long offset = lockstep_blocks * BLAKE2B_BLOCK_LEN;
+        while (leaf_lengths[l] - offset > BLAKE2B_BLOCK_LEN) {
+            blocks[0] = input + offset / BLAKE2B_BLOCK_LEN * stripe + (long) leaf * BLAKE2B_BLOCK_LEN;
+            offset += BLAKE2B_BLOCK_LEN;
+            blake2b_multi_compress(lane_h, blocks, offset, 0, 0, 1);
+        }
+
+        unsigned char last_block[BLAKE2B_BLOCK_LEN];
+        memset(last_block, 0, BLAKE2B_BLOCK_LEN);
+        if (leaf_lengths[l] > offset)
+            memcpy(last_block, input + offset / BLAKE2B_BLOCK_LEN * stripe + (long) leaf * BLAKE2B_BLOCK_LEN,
+                   leaf_lengths[l] - offset);
+        blocks[0] = last_block;
+        blake2b_multi_compress(lane_h, blocks, leaf_lengths[l], ~0ULL, leaf == fanout - 1 ? ~0ULL : 0, 1);
+
+        for (int i = 0; i < BLAKE2B_TREE_INNER_LEN; i++)
+            leaf_outputs[leaf][i] = (unsigned char) (lane_h[i / 8][0] >> (8 * (i % 8)));
+    }
+}
+
+/// Thread body: hashes every group_step'th group of leaves starting from first_group
+/// \param arg Pointer to a blake2b_tree_job_t
+/// \return NULL
+static void *blake2b_tree_worker(void *arg) {
+    const blake2b_tree_job_t *job = arg;
+    for (int group = job->first_group; group < job->fanout / BLAKE2B_LANES; group += job->group_step)
+        blake2b_tree_leaf_group(job->leaf_outputs, job->input, job->length, job->output_len, job->fanout,
+                                group * BLAKE2B_LANES);
+    return NULL;
+}
+
+int blake2b_tree_hash(unsigned char *hash_output, int output_len, const unsigned char *input, long length,
+                      int fanout, int threads) {
+    if (fanout < BLAKE2B_LANES || fanout % BLAKE2B_LANES || fanout > BLAKE2B_TREE_MAX_FANOUT || output_len < 1 ||
+        output_len > BLAKE2B_TREE_INNER_LEN)
+        return 0;
+
+    /* At most one thread per group of leaves, and none for a small share of the message */
+    int groups = fanout / BLAKE2B_LANES;
+    if (threads > groups)
+        threads = groups;
+    if (threads > length / BLAKE2B_TREE_MIN_THREAD_LEN + 1)
+        threads = (int) (length / BLAKE2B_TREE_MIN_THREAD_LEN + 1);
+    if (threads < 1)
+        threads = 1;
+
+    unsigned char leaf_outputs[BLAKE2B_TREE_MAX_FANOUT][BLAKE2B_TREE_INNER_LEN];
+    blake2b_tree_job_t jobs[BLAKE2B_TREE_MAX_FANOUT / BLAKE2B_LANES];
+    pthread_t workers[BLAKE2B_TREE_MAX_FANOUT / BLAKE2B_LANES];
+    int started[BLAKE2B_TREE_MAX_FANOUT / BLAKE2B_LANES];
+    for (int i = 0; i < threads; i++) {
+        jobs[i] = (blake2b_tree_job_t) {leaf_outputs, input, length, output_len, fanout, i, threads};
+        /* A job whose thread cannot be started runs on the calling thread */
+        started[i] = i && pthread_create(&workers[i], NULL, blake2b_tree_worker, &jobs[i]) == 0;
+    }
+    for (int i = 0; i < threads; i++)
+        if (!started[i])
+            blake2b_tree_worker(&jobs[i]);
+    for (int i = 1; i < threads; i++)
+        if (started[i])
+            pthread_join(workers[i], NULL);
+
+    /* Root node over the concatenated leaf outputs (always a multiple of the block length) */
+    uint64_t h[8][BLAKE2B_LANES];
+    const unsigned char *blocks[BLAKE2B_LANES];
+    blake2b_tree_node_init(h, 0, output_len, fanout, 0, 1);
+    long root_len = (long) fanout * BLAKE2B_TREE_INNER_LEN;
+    for (long offset = 0; offset < root_len; offset += BLAKE2B_BLOCK_LEN) {
+        blocks[0] = leaf_outputs[0] + offset;
+        int last = offset + BLAKE2B_BLOCK_LEN == root_len;
+        blake2b_multi_compress(h, blocks, offset + BLAKE2B_BLOCK_LEN, last ? ~0ULL : 0, last ? ~0ULL : 0, 1);
+    }
+
+    for (int i = 0; i < output_len; i++)
+        hash_output[i] = (unsigned char) (h[i / 8][0] >> (8 * (i % 8)));
+    return output_len;
+}
+
+int blake2b_tree_256(unsigned char *hash_output, const unsigned char *input, long length, int fanout, int threads) {
+    return blake2b_tree_hash(hash_output, SHA256_OUTPUT_LEN, input, length, fanout, threads);
+}
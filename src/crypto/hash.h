@@ -27,6 +27,40 @@ int openssl_hash_sha2_256(unsigned char * hash_output, const unsigned char * inp
 int blake2b_256(unsigned char * hash_output, const unsigned char * input , long length);
 
 
+/// Computes the Blake2b-256 of several equal-length inputs at once. The inputs are hashed in lockstep in groups
+/// of four (one SIMD lane per input), and each output is identical to calling blake2b_256 on that input.
+/// \param hash_outputs Array of buffers that the hashes will be stored in (one per input)
+/// \param inputs Array of inputs that we want the hash values
+/// \param length The length of each input
+/// \param lanes Number of inputs
+/// \return The size of each hash
+int blake2b_256_multi(unsigned char *hash_outputs[], const unsigned char *inputs[], long length, int lanes);
+
+
+/// Computes the Blake2b tree hash of a (large) input: the input blocks are dealt round-robin to `fanout` leaves
+/// hashed on the SIMD lanes and on up to `threads` threads, and a root node hashes the leaf outputs. With fanout 4
+/// it is BLAKE2bp. The hash depends on the fanout but not on the number of threads.
+/// \param hash_output Pointer to buffer that the hash will be stored
+/// \param output_len Length of the hash (1 to 64 bytes)
+/// \param input Pointer to the input that we want the hash value
+/// \param length The length of the input
+/// \param fanout Number of leaves (a multiple of 4, at most 64)
+/// \param threads Maximum number of threads
+/// \return The size of the hash, or 0 for unsupported parameters
+int blake2b_tree_hash(unsigned char *hash_output, int output_len, const unsigned char *input, long length,
+                      int fanout, int threads);
+
+
+/// Computes the 256-bit Blake2b tree hash (see blake2b_tree_hash)
+/// \param hash_output Pointer to buffer that the hash will be stored
+/// \param input Pointer to the input that we want the hash value
+/// \param length The length of the input
+/// \param fanout Number of leaves (a multiple of 4, at most 64)
+/// \param threads Maximum number of threads
+/// \return The size of the hash, or 0 for unsupported parameters
+int blake2b_tree_256(unsigned char *hash_output, const unsigned char *input, long length, int fanout, int threads);
+
+
 /// Computes the hash value based on the Blake2b-384 by (https://github.com/rurban/smhasher?tab=readme-ov-file)
 /// \param hash_output Pointer to buffer that the hash will be stored
 /// \param input Pointer to the input that we want the hash value
@@ -12,30 +12,131 @@
 #ifdef JOURNAL
 #include <sys/time.h>
 #endif
+
+#ifdef MESSAGE_DIGEST_TREE
+#ifndef MESSAGE_DIGEST_FANOUT
+#define MESSAGE_DIGEST_FANOUT 4 /* BLAKE2bp */
+#endif
+#ifndef MESSAGE_DIGEST_THREADS
+#define MESSAGE_DIGEST_THREADS 1
+#endif
+#ifndef MESSAGE_DIGEST_TREE_MIN_LEN
+#define MESSAGE_DIGEST_TREE_MIN_LEN 4096
+#endif
+#endif
+
 #ifdef JOURNAL
 /* Timing variables */
 static struct timeval start_time, end_time;
 static double mumhors_sign_time = 0;
 static double mumhors_verify_time = 0;
 
-void mumhors_report_time(int total_tests) {
+void mumhors_report_time(long long total_tests) {
     printf("-- Total Sign time (w rejection sampling w.o. bitmap): %0.12f s\n", mumhors_sign_time);
     printf("-- Total Verify time (w rejection checking): %0.12f s \n", mumhors_verify_time);
 
     printf("-- Each sign time (w rejection sampling w.o. bitmap): %0.12f micros\n", mumhors_sign_time/total_tests * 1000000);
     printf("-- Each verify time (w rejection checking): %0.12f micros\n", mumhors_verify_time/total_tests * 1000000);
 }
+
+void mumhors_report_rs_stats(const char *title, const mumhors_rs_stats_t *stats) {
+    const char *stage_names[RS_STAGE_CTR + 1] = {"Hash", "Pad 1", "Pad 2", "Pad 3", "Ctr"};
+
+    printf("\n================ Rejection Sampling Report (%s) ================\n", title);
+    printf("#MESSAGES: %llu\n", stats->messages);
+    if (stats->rejected)
+        printf("#REJECTED: %llu\n", stats->rejected);
+    for (int stage = 0; stage <= RS_STAGE_CTR; stage++)
+        printf("--- Stage %-5s: %llu (%0.4f%%)\n", stage_names[stage], stats->stage_hits[stage],
+               stats->messages ? 100.0 * stats->stage_hits[stage] / stats->messages : 0);
+    printf("--- Max ctr: %u\n", stats->max_ctr);
+    printf("--- AVG attempts: %0.6f\n", stats->messages ? (double) stats->attempts / stats->messages : 0);
+
+    printf("\n------- Attempts histogram -------\n");
+    for (int bucket = 0; bucket < RS_ATTEMPT_HISTOGRAM_BUCKETS; bucket++)
+        if (stats->attempt_histogram[bucket])
+            printf("--- [%llu, %llu]: %llu\n", 1ULL << bucket, (2ULL << bucket) - 1, stats->attempt_histogram[bucket]);
+
+    printf("\n------- Timings -------\n");
+    printf("--- TT Sampling: %0.12f micros\n", stats->sampling_time * 1000000);
+    printf("--- TT Rest: %0.12f micros\n", stats->other_time * 1000000);
+    printf("--- Sampling share: %0.4f%%\n", stats->sampling_time + stats->other_time > 0
+                                               ? 100 * stats->sampling_time / (stats->sampling_time + stats->other_time)
+                                               : 0);
+}
 #endif
 
+/// Records the outcome of one rejection sampling in the telemetry
+/// \param stats Pointer to the telemetry
+/// \param stage Successful stage
+/// \param ctr Counter of the successful stage
+static void rs_stats_record(mumhors_rs_stats_t *stats, int stage, unsigned int ctr) {
+    unsigned long long attempts = stage == RS_STAGE_CTR ? RS_STAGE_CTR + 1ULL + ctr : stage + 1ULL;
+
+    stats->messages++;
+    stats->stage_hits[stage]++;
+    stats->attempts += attempts;
+    stats->attempt_histogram[63 - __builtin_clzll(attempts)]++;
+    if (ctr > stats->max_ctr)
+        stats->max_ctr = ctr;
+}
+
+void mumhors_signer_rs_stats(const mumhors_signer_t *signer, mumhors_rs_stats_t *stats) {
+    *stats = signer->rs_stats;
+}
+
+void mumhors_verifier_rs_stats(const mumhors_verifier_t *verifier, mumhors_rs_stats_t *stats) {
+    *stats = verifier->rs_stats;
+}
+
+
+/// Fills the remaining capacity from the counters of a window
+/// \param capacity Pointer to the capacity
+/// \param k HORS k parameter
+/// \param c Number of columns of the matrix
+/// \param r Number of rows of the matrix
+/// \param signatures Signatures issued or accepted
+/// \param nxt_row_number Number of the next row to allocate (the rows allocated so far)
+/// \param window_keys Available keys in the window
+/// \param discarded_keys Available keys of the evicted rows
+/// \param window_size Keys that a signature needs in the window
+static void capacity_fill(mumhors_capacity_t *capacity, int k, int c, long long r, long long signatures,
+                          long long nxt_row_number, long long window_keys, long long discarded_keys, int window_size) {
+    /* The keys of the allocated rows are in the window, used or discarded */
+    capacity->used_keys = nxt_row_number * c - window_keys - discarded_keys;
+    capacity->signatures = signatures;
+    capacity->window_keys = window_keys;
+    capacity->unallocated_keys = (r - nxt_row_number) * c;
+    capacity->discarded_keys = discarded_keys;
+    capacity->discard_rate = capacity->signatures ? (double) discarded_keys / capacity->signatures : 0;
+
+    /* A signature needs a full window before it, and takes k keys plus its share of the discarded ones */
+    long long available = window_keys + capacity->unallocated_keys;
+    capacity->remaining_signatures = available < window_size
+                                         ? 0
+                                         : (long long) ((available - window_size) / (k + capacity->discard_rate)) + 1;
+}
+
+void mumhors_signer_capacity(const mumhors_signer_t *signer, mumhors_capacity_t *capacity) {
+    const bitmap_t *bm = &signer->bm;
+    capacity_fill(capacity, signer->k, bm->c, bm->r, signer->signatures, bm->nxt_row_number, bm->set_bits,
+                  bm->discarded_bits, bm->window_size);
+}
+
+void mumhors_verifier_capacity(const mumhors_verifier_t *verifier, mumhors_capacity_t *capacity) {
+    capacity_fill(capacity, verifier->k, verifier->c, verifier->r, verifier->signatures, verifier->nxt_row_number,
+                  verifier->active_pks, verifier->discarded_pks, verifier->windows_size);
+}
+
 
 
 
-void mumhors_pk_gen(public_key_matrix_t *pk_matrix, const unsigned char *seed, int seed_len, int row, int col) {
+void mumhors_pk_gen(public_key_matrix_t *pk_matrix, const unsigned char *seed, int seed_len, long long row, int col) {
     /* Initialize the linked list variables */
     pk_matrix->head = NULL;
     pk_matrix->tail = NULL;
 
-    for (int i = 0; i < row; i++) {
+    for (long long i = 0; i < row; i++) {
         /* Create a new public key node and allocating given number of public keys in each row */
         public_key_t *pk_node = malloc(sizeof(public_key_t));
         pk_node->pks = malloc(sizeof(unsigned char *) * col);
@@ -44,11 +145,11 @@ void mumhors_pk_gen(public_key_matrix_t *pk_matrix, const unsigned char *seed, i
         for (int j = 0; j < col; j++) {
             unsigned char *pk = malloc(SHA256_OUTPUT_LEN);
             unsigned char sk[SHA256_OUTPUT_LEN];
-            unsigned char *new_seed = malloc(seed_len + 4 + 4);
+            unsigned char *new_seed = malloc(seed_len + SK_ROW_BYTES + SK_COL_BYTES);
             memcpy(new_seed, seed, seed_len);
-            memcpy(new_seed + seed_len, &i, 4);
-            memcpy(new_seed + seed_len + 4, &j, 4);
-            blake2b_256(sk, new_seed, seed_len + 4 + 4);
+            memcpy(new_seed + seed_len, &i, SK_ROW_BYTES);
+            memcpy(new_seed + seed_len + SK_ROW_BYTES, &j, SK_COL_BYTES);
+            blake2b_256(sk, new_seed, seed_len + SK_ROW_BYTES + SK_COL_BYTES);
             blake2b_256(pk, sk, SHA256_OUTPUT_LEN);
             pk_node->pks[j] = pk;
             free(new_seed);
@@ -68,8 +169,9 @@ void mumhors_pk_gen(public_key_matrix_t *pk_matrix, const unsigned char *seed, i
     }
 }
 
-void
-mumhors_init_signer(mumhors_signer_t *signer, unsigned char *seed, int seed_len, int t, int k, int l, int rt, int r) {
+int
+mumhors_init_signer(mumhors_signer_t *signer, unsigned char *seed, int seed_len, int t, int k, int l, int rt,
+                    long long r, const bitmap_engine_t *engine) {
     /* Setting the signer hyperparameters */
     signer->seed = seed;
     signer->seed_len = seed_len;
@@ -80,9 +182,30 @@ mumhors_init_signer(mumhors_signer_t *signer, unsigned char *seed, int seed_len,
     signer->r = r;
     signer->l = l;
     signer->signature.signature = malloc((signer->k * signer->l) / 8);
+    if (!signer->signature.signature)
+        return MUMHORS_INIT_FAILED;
+    signer->signatures = 0;
+    memset(&signer->rs_stats, 0, sizeof(signer->rs_stats));
 
     /* Initializing the underlying bitmap data structure */
-    bitmap_init(&signer->bm, signer->r, signer->t, signer->rt, signer->t);
+    if (bitmap_init(&signer->bm, engine, signer->r, signer->t, signer->rt, signer->t) != BITMAP_INIT_SUCCESS) {
+        free(signer->signature.signature);
+        return MUMHORS_INIT_FAILED;
+    }
+    return MUMHORS_INIT_SUCCESS;
+}
+
+void mumhors_signer_set_eviction(mumhors_signer_t *signer, int policy, int param) {
+    bitmap_set_eviction(&signer->bm, policy, param);
+}
+
+void mumhors_signer_set_row_limit(mumhors_signer_t *signer, int min_rows, int target, int epoch) {
+    bitmap_set_row_limit(&signer->bm, min_rows, target, epoch);
+}
+
+void mumhors_signer_set_extension_run(mumhors_signer_t *signer, int signatures) {
+    /* The first signature of the run gets the window size, the others k indices each */
+    bitmap_set_headroom(&signer->bm, (signatures - 1) * signer->k);
 }
 
 void mumhors_delete_signer(mumhors_signer_t *signer) {
@@ -92,121 +215,174 @@ void mumhors_delete_signer(mumhors_signer_t *signer) {
 }
 
 static int check_if_indices_are_distinct(unsigned char *value, int k, int chunk, int *message_indices,
-    int** sorted_indices) {
-
-    int *new_indices = malloc(sizeof(int) * k);
-    *sorted_indices = new_indices;
+    int *sorted_indices) {
 
+    /* Insert each index into the (descending) sorted prefix, so a candidate is rejected as soon as
+     * its first repeated index shows up. Most of the counter candidates fail early this way. */
     for (int i = 0; i < k; i++) {
-        new_indices[i] = read_bits_as_4bytes(value, i + 1, chunk);
-        message_indices[i] = new_indices[i];
-    }
+        int index = read_bits_as_4bytes(value, i + 1, chunk);
+        message_indices[i] = index;
 
-    array_sort(new_indices, k);
-
-    for (int i = 1; i < k; i++) {
-        if (new_indices[i] == new_indices[i - 1]) {
-            return 0;
+        int j = i - 1;
+        while (j >= 0 && sorted_indices[j] < index) {
+            sorted_indices[j + 1] = sorted_indices[j];
+            j--;
         }
+        if (j >= 0 && sorted_indices[j] == index)
+            return 0;
+        sorted_indices[j + 1] = index;
     }
     return 1;
 }
 
+void mumhors_message_digest(unsigned char *digest, const unsigned char *message, long message_len) {
+#ifdef MESSAGE_DIGEST_TREE
+    /* Below one stripe per leaf the tree only adds the leaf and root overhead */
+    if (message_len >= MESSAGE_DIGEST_TREE_MIN_LEN) {
+        blake2b_tree_256(digest, message, message_len, MESSAGE_DIGEST_FANOUT, MESSAGE_DIGEST_THREADS);
+        return;
+    }
+#endif
+    blake2b_256(digest, message, message_len);
+}
+
+const unsigned char mumhors_rs_pads[RS_NUM_PADS][SHA256_OUTPUT_LEN] = {
+    {
+        0x6b, 0x8f, 0x34, 0x1a, 0xdf, 0x21, 0x5e, 0xa3, 0x79, 0x2d, 0xe7, 0xc1, 0x5b, 0x6a, 0x1b, 0x3f, 0x5c, 0xe0,
+        0x1d, 0x8b, 0x3d, 0xf2, 0x7e, 0x4a, 0xe8, 0xb1, 0x5d, 0x9c, 0x6f, 0x43, 0x84, 0x2e
+    },
+    {
+        0xab, 0xf9, 0x27, 0xcd, 0x12, 0xe3, 0x89, 0x45, 0xd8, 0x66, 0x97, 0xa4, 0xbc, 0x8d, 0x5e, 0xf1, 0x4c, 0x32,
+        0x7a, 0x90, 0x8f, 0xb3, 0xd9, 0xe6, 0x1e, 0xac, 0x74, 0x91, 0x5b, 0xdf, 0x2c, 0xe5
+    },
+    {
+        0x59, 0x9f, 0x4b, 0x8a, 0x36, 0xf4, 0xa7, 0x28, 0x91, 0x6e, 0x2b, 0x5d, 0xc9, 0x72, 0xf2, 0x13, 0x46, 0x8e,
+        0x93, 0xb4, 0xd7, 0x6a, 0xe1, 0x5f, 0x0b, 0xc4, 0x89, 0x71, 0x3d, 0x2a, 0x94, 0xfc
+    },
+};
+
+/// Performs the rejection sampling on the message: the digest of the message, then the hash XORed with each of the
+/// pads, and finally the hash (with all the pads) concatenated with an increasing counter, until the k extracted
+/// indices are distinct.
+/// \param message Pointer to the message
+/// \param message_len Message's length
+/// \param k HORS k parameter
+/// \param t HORS t parameter
+/// \param message_indices Buffer for the k indices in message order
+/// \param sorted_indices Buffer for the k indices in descending order
+/// \param ctr Pointer to variable which will store the counter (0 unless the counter stage succeeded)
+/// \return The stage that succeeded (RS_STAGE_HASH, RS_STAGE_PAD1..RS_STAGE_PAD3 or RS_STAGE_CTR)
 static int perform_rejection_sampling(const unsigned char *message, int message_len, int k, int t,
-                                      int* message_indices, int** sorted_indices) {
-    unsigned char pads[3][32] = {
-        {
-            0x6b, 0x8f, 0x34, 0x1a, 0xdf, 0x21, 0x5e, 0xa3, 0x79, 0x2d, 0xe7, 0xc1, 0x5b, 0x6a, 0x1b, 0x3f, 0x5c, 0xe0,
-            0x1d, 0x8b, 0x3d, 0xf2, 0x7e, 0x4a, 0xe8, 0xb1, 0x5d, 0x9c, 0x6f, 0x43, 0x84, 0x2e
-        },
-        {
-            0xab, 0xf9, 0x27, 0xcd, 0x12, 0xe3, 0x89, 0x45, 0xd8, 0x66, 0x97, 0xa4, 0xbc, 0x8d, 0x5e, 0xf1, 0x4c, 0x32,
-            0x7a, 0x90, 0x8f, 0xb3, 0xd9, 0xe6, 0x1e, 0xac, 0x74, 0x91, 0x5b, 0xdf, 0x2c, 0xe5
-        },
-        {
-            0x59, 0x9f, 0x4b, 0x8a, 0x36, 0xf4, 0xa7, 0x28, 0x91, 0x6e, 0x2b, 0x5d, 0xc9, 0x72, 0xf2, 0x13, 0x46, 0x8e,
-            0x93, 0xb4, 0xd7, 0x6a, 0xe1, 0x5f, 0x0b, 0xc4, 0x89, 0x71, 0x3d, 0x2a, 0x94, 0xfc
-        },
-    };
+                                      int* message_indices, int* sorted_indices, unsigned int *ctr) {
+    *ctr = 0;
 
     /* Hash one time */
     unsigned char hash_ctr_buffer[SHA256_OUTPUT_LEN + 4];
-    blake2b_256(hash_ctr_buffer, message, message_len);
+    mumhors_message_digest(hash_ctr_buffer, message, message_len);
 
     if (check_if_indices_are_distinct(hash_ctr_buffer, k, (int) log2(t), message_indices, sorted_indices))
-        return 0;
+        return RS_STAGE_HASH;
 
 
     /* XOR with pads 1-3 and try again */
-    for (int j = 0; j < 3; j++) {
+    for (int j = 0; j < RS_NUM_PADS; j++) {
 
         for (int i = 0; i < 32; i++)
-            hash_ctr_buffer[i] ^= pads[j][i];
+            hash_ctr_buffer[i] ^= mumhors_rs_pads[j][i];
         if (check_if_indices_are_distinct(hash_ctr_buffer, k, (int) log2(t), message_indices, sorted_indices))
-            return 0;
+            return RS_STAGE_PAD1 + j;
     }
 
     /* Use Ctr to resolve */
-    unsigned int ctr = 0;
+    unsigned int candidate = 0;
+#ifdef RS_CTR_LANES
+    /* Evaluate RS_CTR_LANES consecutive counters at once with the multi-buffer hash, and take the smallest one
+     * that passes. This returns the same counter as the serial loop below. */
+    unsigned char candidate_buffers[RS_CTR_LANES][SHA256_OUTPUT_LEN + sizeof(candidate)];
+    unsigned char candidate_hashes[RS_CTR_LANES][SHA256_OUTPUT_LEN];
+    const unsigned char *candidate_inputs[RS_CTR_LANES];
+    unsigned char *candidate_outputs[RS_CTR_LANES];
+    for (int lane = 0; lane < RS_CTR_LANES; lane++) {
+        memcpy(candidate_buffers[lane], hash_ctr_buffer, SHA256_OUTPUT_LEN);
+        candidate_inputs[lane] = candidate_buffers[lane];
+        candidate_outputs[lane] = candidate_hashes[lane];
+    }
+
     while (1) {
-        unsigned char hash_result[SHA256_OUTPUT_LEN];
-        mempcpy(hash_ctr_buffer + SHA256_OUTPUT_LEN, &ctr, sizeof(ctr));
-        blake2b_256(hash_result, hash_ctr_buffer, SHA256_OUTPUT_LEN + sizeof(ctr));
+        for (int lane = 0; lane < RS_CTR_LANES; lane++) {
+            unsigned int candidate_ctr = candidate + lane;
+            memcpy(candidate_buffers[lane] + SHA256_OUTPUT_LEN, &candidate_ctr, sizeof(candidate_ctr));
+        }
+        blake2b_256_multi(candidate_outputs, candidate_inputs, SHA256_OUTPUT_LEN + sizeof(candidate), RS_CTR_LANES);
 
-        if (check_if_indices_are_distinct(hash_result, k, (int) log2(t), message_indices, sorted_indices))
-            return ctr;
-        ctr++;
+        for (int lane = 0; lane < RS_CTR_LANES; lane++) {
+            if (check_if_indices_are_distinct(candidate_hashes[lane], k, (int) log2(t), message_indices,
+                                              sorted_indices)) {
+                *ctr = candidate + lane;
+                return RS_STAGE_CTR;
+            }
+        }
+        candidate += RS_CTR_LANES;
 
         /* Overflow the unsigned counter variable*/
-        if (ctr == 0)
-            assert(ctr != 0);
+        if (candidate < RS_CTR_LANES)
+            assert(candidate >= RS_CTR_LANES);
     }
+#else
+    while (1) {
+        unsigned char hash_result[SHA256_OUTPUT_LEN];
+        mempcpy(hash_ctr_buffer + SHA256_OUTPUT_LEN, &candidate, sizeof(candidate));
+        blake2b_256(hash_result, hash_ctr_buffer, SHA256_OUTPUT_LEN + sizeof(candidate));
+
+        if (check_if_indices_are_distinct(hash_result, k, (int) log2(t), message_indices, sorted_indices)) {
+            *ctr = candidate;
+            return RS_STAGE_CTR;
+        }
+        candidate++;
 
-    return ctr;
+        /* Overflow the unsigned counter variable*/
+        if (candidate == 0)
+            assert(candidate != 0);
+    }
+#endif
 }
 
+/// Checks the rejection sampling of the signer. The stage recorded in the signature tells which derivation
+/// produced the indices, so the verifier performs exactly one derivation and one distinctness check.
+/// \param message Pointer to the message
+/// \param message_len Message's length
+/// \param k HORS k parameter
+/// \param t HORS t parameter
+/// \param indices Buffer for the k indices in message order
+/// \param stage Rejection sampling stage recorded in the signature
+/// \param ctr Counter recorded in the signature
+/// \param sorted_indices Buffer for the k indices in descending order
+/// \return 1 if the derived indices are distinct, 0 otherwise
 static int check_rejection_sampling(const unsigned char *message, int message_len, int k, int t, int *indices,
-                                    unsigned int ctr, int** sorted_indices) {
-    unsigned char pads[3][32] = {
-        {
-            0x6b, 0x8f, 0x34, 0x1a, 0xdf, 0x21, 0x5e, 0xa3, 0x79, 0x2d, 0xe7, 0xc1, 0x5b, 0x6a, 0x1b, 0x3f, 0x5c, 0xe0,
-            0x1d, 0x8b, 0x3d, 0xf2, 0x7e, 0x4a, 0xe8, 0xb1, 0x5d, 0x9c, 0x6f, 0x43, 0x84, 0x2e
-        },
-        {
-            0xab, 0xf9, 0x27, 0xcd, 0x12, 0xe3, 0x89, 0x45, 0xd8, 0x66, 0x97, 0xa4, 0xbc, 0x8d, 0x5e, 0xf1, 0x4c, 0x32,
-            0x7a, 0x90, 0x8f, 0xb3, 0xd9, 0xe6, 0x1e, 0xac, 0x74, 0x91, 0x5b, 0xdf, 0x2c, 0xe5
-        },
-        {
-            0x59, 0x9f, 0x4b, 0x8a, 0x36, 0xf4, 0xa7, 0x28, 0x91, 0x6e, 0x2b, 0x5d, 0xc9, 0x72, 0xf2, 0x13, 0x46, 0x8e,
-            0x93, 0xb4, 0xd7, 0x6a, 0xe1, 0x5f, 0x0b, 0xc4, 0x89, 0x71, 0x3d, 0x2a, 0x94, 0xfc
-        },
-    };
+                                    unsigned char stage, unsigned int ctr, int* sorted_indices) {
+    /* Reject malformed signatures: an unknown stage, or a counter outside the counter stage */
+    if (stage > RS_STAGE_CTR || (stage != RS_STAGE_CTR && ctr != 0))
+        return 0;
 
     /* Hash one time */
     unsigned char hash_ctr_buffer[SHA256_OUTPUT_LEN + 4];
-    blake2b_256(hash_ctr_buffer, message, message_len);
+    mumhors_message_digest(hash_ctr_buffer, message, message_len);
 
-    if (check_if_indices_are_distinct(hash_ctr_buffer, k, (int) log2(t), indices, sorted_indices))
-        return 1;
-
-
-    /* XOR with pads 1-3 and try again */
-    for (int j = 0; j < 3; j++) {
+    /* The pads are applied cumulatively, and the counter stage starts from the hash with all three pads */
+    int num_pads = stage < RS_STAGE_CTR ? stage : RS_NUM_PADS;
+    for (int j = 0; j < num_pads; j++)
         for (int i = 0; i < 32; i++)
-            hash_ctr_buffer[i] ^= pads[j][i];
-        if (check_if_indices_are_distinct(hash_ctr_buffer, k, (int) log2(t), indices, sorted_indices))
-            return 1;
-    }
+            hash_ctr_buffer[i] ^= mumhors_rs_pads[j][i];
+
+    if (stage != RS_STAGE_CTR)
+        return check_if_indices_are_distinct(hash_ctr_buffer, k, (int) log2(t), indices, sorted_indices);
 
     /* Use Ctr to resolve */
     unsigned char target_hash[SHA256_OUTPUT_LEN];
     mempcpy(hash_ctr_buffer + SHA256_OUTPUT_LEN, &ctr, sizeof(ctr));
     blake2b_256(target_hash, hash_ctr_buffer, SHA256_OUTPUT_LEN + sizeof(ctr));
 
-    if (check_if_indices_are_distinct(target_hash, k, (int) log2(t), indices, sorted_indices))
-        return 1;
-
-    return 0;
+    return check_if_indices_are_distinct(target_hash, k, (int) log2(t), indices, sorted_indices);
 }
 
 int mumhors_sign_message(mumhors_signer_t *signer, const unsigned char *message, int message_len) {
@@ -219,29 +395,37 @@ int mumhors_sign_message(mumhors_signer_t *signer, const unsigned char *message,
     /* Extract the indices from the hash of the message while ensuring they are different
      * through a process known as rejection sampling. */
 
-    unsigned char *new_seed = malloc(signer->seed_len + 4 + 4);
+    unsigned char *new_seed = malloc(signer->seed_len + SK_ROW_BYTES + SK_COL_BYTES);
 
 #ifdef JOURNAL
+    struct timeval sampling_start_time, sampling_end_time, sign_end_time;
     gettimeofday(&start_time, NULL);
+    sampling_start_time = start_time;
 #endif
 
-    int* sorted_indices;
-    signer->signature.ctr = perform_rejection_sampling(message, message_len, signer->k, signer->t, message_indices,
-        &sorted_indices);
+    int sorted_indices[signer->k];
+    signer->signature.stage = perform_rejection_sampling(message, message_len, signer->k, signer->t,
+                                                         message_indices, sorted_indices, &signer->signature.ctr);
+    rs_stats_record(&signer->rs_stats, signer->signature.stage, signer->signature.ctr);
+#ifdef JOURNAL
+    gettimeofday(&sampling_end_time, NULL);
+    signer->rs_stats.sampling_time += (sampling_end_time.tv_sec - sampling_start_time.tv_sec) + (
+        sampling_end_time.tv_usec - sampling_start_time.tv_usec) / 1.0e6;
+#endif
 
 
-    for (int i = 0; i < signer->k; i++) {
-        int row_number, col_number;
-        /* Getting the row and colum numbers for the given index */
-        bitmap_get_row_colum_with_index(&signer->bm, message_indices[i], &row_number, &col_number);
+    /* Getting the row and colum numbers of all the indices and unsetting them in the bitmap */
+    long long row_numbers[signer->k];
+    int col_numbers[signer->k];
+    bitmap_select_and_clear(&signer->bm, message_indices, sorted_indices, signer->k, row_numbers, col_numbers);
 
-        /* Create the respective private key and build the signature */
+    for (int i = 0; i < signer->k; i++) {
         /* Create the respective private key and build the signature */
         unsigned char sk[SHA256_OUTPUT_LEN];
         memcpy(new_seed, signer->seed, signer->seed_len);
-        memcpy(new_seed + signer->seed_len, &row_number, 4);
-        memcpy(new_seed + signer->seed_len + 4, &col_number, 4);
-        blake2b_256(sk, new_seed, signer->seed_len + 4 + 4);
+        memcpy(new_seed + signer->seed_len, &row_numbers[i], SK_ROW_BYTES);
+        memcpy(new_seed + signer->seed_len + SK_ROW_BYTES, &col_numbers[i], SK_COL_BYTES);
+        blake2b_256(sk, new_seed, signer->seed_len + SK_ROW_BYTES + SK_COL_BYTES);
         memcpy(signer->signature.signature + i * SHA256_OUTPUT_LEN, sk, SHA256_OUTPUT_LEN);
     }
 
@@ -251,23 +435,43 @@ int mumhors_sign_message(mumhors_signer_t *signer, const unsigned char *message,
 #endif
 
     free(new_seed);
-    /* Unsetting the indices in the bitmap */
-    bitmap_unset_indices_in_window(&signer->bm, sorted_indices, signer->k);
-    free(sorted_indices);
     free(message_indices);
 
 
 
-    /* Extending the bitmap matrix for later usage. This can be optimized to be done every t/k messages */
+    /* Extending the bitmap matrix for later usage (with the headroom of the extension run, if it is set) */
+    int sign_status = SIGN_SUCCESS;
     if (bitmap_extend_matrix(&signer->bm) == BITMAP_EXTENSION_FAILED)
-        return SIGN_NO_MORE_ROW_FAILED;
-    return SIGN_SUCCESS;
+        sign_status = SIGN_NO_MORE_ROW_FAILED;
+    else
+        signer->signatures++;
+
+#ifdef JOURNAL
+    gettimeofday(&sign_end_time, NULL);
+    signer->rs_stats.other_time += (sign_end_time.tv_sec - sampling_end_time.tv_sec) + (
+        sign_end_time.tv_usec - sampling_end_time.tv_usec) / 1.0e6;
+#endif
+    return sign_status;
 }
 
 
-void
-mumhors_init_verifier(mumhors_verifier_t *verifier, public_key_matrix_t pk_matrix, int t, int k, int l, int r, int c,
-                      int rt, int window_size) {
+/// Rebuilds the window rows and the Fenwick tree over their available public keys (after the window changed)
+/// \param verifier Pointer to MUMHORS verifier struct
+static void mumhors_verifier_index_rebuild(mumhors_verifier_t *verifier) {
+    int counts[verifier->rt];
+    public_key_t *pk_row = verifier->pk_matrix.head;
+    for (int position = 0; position < verifier->active_rows; position++) {
+        verifier->window_rows[position] = pk_row;
+        counts[position] = pk_row->available_pks;
+        pk_row = pk_row->next;
+    }
+    fenwick_build(&verifier->pks_index, counts, verifier->active_rows);
+}
+
+
+int
+mumhors_init_verifier(mumhors_verifier_t *verifier, public_key_matrix_t pk_matrix, int t, int k, int l, long long r,
+                      int c, int rt, int window_size) {
     /* Setting the hyper parameters of the verifier */
     verifier->t = t;
     verifier->k = k;
@@ -275,13 +479,65 @@ mumhors_init_verifier(mumhors_verifier_t *verifier, public_key_matrix_t pk_matri
     verifier->r = r;
     verifier->c = c;
     verifier->rt = rt;
-    verifier->active_pks = verifier->rt * verifier->c;
+    verifier->active_pks = (long long) verifier->rt * verifier->c;
     verifier->windows_size = window_size;
     verifier->nxt_row_number = verifier->rt; /* We consider rt number of rows in our window initially */
+    verifier->active_rows = verifier->rt;
     verifier->pk_matrix = pk_matrix;
+
+    /* The window indices and the Fenwick sums over the rows are ints, as in the signer's bitmap */
+    if (verifier->active_pks > BITMAP_MAX_WINDOW_BITS)
+        return MUMHORS_INIT_FAILED;
+    verifier->window_rows = malloc(sizeof(public_key_t *) * verifier->rt);
+    verifier->free_slots = malloc(sizeof(int) * verifier->rt);
+    verifier->free_count = 0;
+    if (!verifier->window_rows || !verifier->free_slots || fenwick_init(&verifier->pks_index, verifier->rt)) {
+        free(verifier->window_rows);
+        free(verifier->free_slots);
+        return MUMHORS_INIT_FAILED;
+    }
+    if (minheap_init(&verifier->eviction_heap, verifier->rt)) {
+        fenwick_delete(&verifier->pks_index);
+        free(verifier->window_rows);
+        free(verifier->free_slots);
+        return MUMHORS_INIT_FAILED;
+    }
+    verifier->eviction_policy = EVICTION_FEWEST;
+    verifier->eviction_param = 0;
+    verifier->discarded_pks = 0;
+    verifier->discarded_rows = 0;
+    row_limit_init(&verifier->row_limit, verifier->rt);
+    verifier->headroom = 0;
+    mumhors_verifier_index_rebuild(verifier);
+    for (int position = 0; position < verifier->active_rows; position++) {
+        public_key_t *pk_row = verifier->window_rows[position];
+        pk_row->slot = position;
+        minheap_push(&verifier->eviction_heap, pk_row->slot, pk_row->available_pks, pk_row->number);
+    }
+    verifier->signatures = 0;
+    memset(&verifier->rs_stats, 0, sizeof(verifier->rs_stats));
+    return MUMHORS_INIT_SUCCESS;
+}
+
+void mumhors_verifier_set_eviction(mumhors_verifier_t *verifier, int policy, int param) {
+    verifier->eviction_policy = policy;
+    verifier->eviction_param = param;
+}
+
+void mumhors_verifier_set_row_limit(mumhors_verifier_t *verifier, int min_rows, int target, int epoch) {
+    row_limit_set_adaptive(&verifier->row_limit, min_rows, target, epoch);
 }
 
-void mumhors_delete_verifier(const mumhors_verifier_t *verifier) {
+void mumhors_verifier_set_extension_run(mumhors_verifier_t *verifier, int signatures) {
+    verifier->headroom = (signatures - 1) * verifier->k;
+}
+
+void mumhors_delete_verifier(mumhors_verifier_t *verifier) {
+    free(verifier->window_rows);
+    free(verifier->free_slots);
+    fenwick_delete(&verifier->pks_index);
+    minheap_delete(&verifier->eviction_heap);
+
     /* The verifier is public key consumer and hence, it is responsible to deallocate the
      * memory allocated for it in the key generation function. This is required, as in MUM-HORS
      * a huge number of public keys are stored on the verifier side, which need to be removed as they are used
@@ -303,59 +559,93 @@ void mumhors_delete_verifier(const mumhors_verifier_t *verifier) {
 }
 
 
+/// Takes a removed row out of the eviction heap and frees its slot for the rows entering the window
+/// \param verifier Pointer to MUMHORS verifier struct
+/// \param slot Slot of the row
+static void mumhors_verifier_release_slot(mumhors_verifier_t *verifier, int slot) {
+    minheap_remove(&verifier->eviction_heap, slot);
+    verifier->free_slots[verifier->free_count++] = slot;
+}
+
+
+/// Returns the window position of a window row in O(log rt) (the window is sorted by row number)
+/// \param verifier Pointer to MUMHORS verifier struct
+/// \param number Row number of a window row
+/// \return Window position
+static int mumhors_verifier_window_position(const mumhors_verifier_t *verifier, long long number) {
+    int low = 0, high = verifier->active_rows - 1;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (verifier->window_rows[mid]->number < number)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+
 /// Performs a clean up on the matrix rows by removing rows that have been depleted (0 PKs)
 /// \param verifier Pointer to MUMHORS verifier struct
 /// \return Number of cleaned rows
 static int mumhors_verifier_cleanup_rows(mumhors_verifier_t *verifier) {
-    /* Count the number of rows we cleaned */
+    /* The eviction heap counts the depleted rows, so there is nothing to scan for when there is none */
+    if (!verifier->eviction_heap.empty)
+        return 0;
+
+    /* Count the number of cleaned rows */
     int cleaned_rows = 0;
-    public_key_t *pk_row = verifier->pk_matrix.head;
-    // public_key_t *prev;
 
-    /* Loop and remove the row with 0 remained public key */
-    while (pk_row) {
-        if (!pk_row->available_pks) {
-            if (pk_row == verifier->pk_matrix.head)
-                verifier->pk_matrix.head = verifier->pk_matrix.head->next;
-            else {
-                public_key_t *prev = verifier->pk_matrix.head;
-                while (prev->next != pk_row) { prev = prev->next; }
-                prev->next = pk_row->next;
-
-                /* Updating the tail pointer */
-                if (pk_row == verifier->pk_matrix.tail)
-                    verifier->pk_matrix.tail = prev;
-            }
+    /* Relink the list over the depleted rows of the window. The rows after the window are full. */
+    public_key_t *rest = verifier->window_rows[verifier->active_rows - 1]->next;
+    public_key_t *previous = NULL;
+    for (int position = 0; position < verifier->active_rows; position++) {
+        public_key_t *pk_row = verifier->window_rows[position];
+        if (pk_row->available_pks) {
+            if (previous)
+                previous->next = pk_row;
+            else
+                verifier->pk_matrix.head = pk_row;
+            previous = pk_row;
+        } else {
             cleaned_rows++;
-
-            public_key_t *target_pk = pk_row;
-            pk_row = pk_row->next;
+            mumhors_verifier_release_slot(verifier, pk_row->slot);
 
             /* Deallocating the array of PK addresses.
              * Note that the actual PKs have been deallocated during unsetting */
-            free(target_pk->pks);
-            free(target_pk);
-        } else
-            pk_row = pk_row->next;
+            free(pk_row->pks);
+            free(pk_row);
+        }
     }
+    if (previous)
+        previous->next = rest;
+    else
+        verifier->pk_matrix.head = rest;
+    if (!rest)
+        verifier->pk_matrix.tail = previous;
     return cleaned_rows;
 }
 
 
-/// Given a pointer to a row of the matrix, it removes that row from the matrix (linked list)
+/// Given the window position of a row, it removes that row from the matrix (linked list)
 /// \param verifier Pointer to MUMHORS verifier struct
-/// \param pk_row Pointer to the desired row
-static void mumhors_verifier_remove_row(mumhors_verifier_t *verifier, public_key_t *pk_row) {
+/// \param position Window position of the desired row
+static void mumhors_verifier_remove_row(mumhors_verifier_t *verifier, int position) {
+    public_key_t *pk_row = verifier->window_rows[position];
+
+    /* The previous row is the one before it in the window */
     if (pk_row == verifier->pk_matrix.head)
         verifier->pk_matrix.head = verifier->pk_matrix.head->next;
     else {
-        public_key_t *temp = verifier->pk_matrix.head;
-        while (temp->next != pk_row) { temp = temp->next; }
-        temp->next = pk_row->next;
+        public_key_t *previous = verifier->window_rows[position - 1];
+        previous->next = pk_row->next;
         if (pk_row == verifier->pk_matrix.tail)
-            verifier->pk_matrix.tail = temp;
+            verifier->pk_matrix.tail = previous;
     }
     verifier->active_pks -= pk_row->available_pks;
+    verifier->discarded_pks += pk_row->available_pks;
+    verifier->discarded_rows++;
+    mumhors_verifier_release_slot(verifier, pk_row->slot);
 
     /* Deallocating the public key node */
     free(pk_row->pks);
@@ -370,43 +660,59 @@ static int mumhors_verifier_alloc_row_virtually(mumhors_verifier_t *verifier) {
     if (verifier->nxt_row_number >= verifier->r)
         return PKMATRIX_NO_MORE_ROWS_TO_ALLOCATE;
 
-    /* Number of removed rows in this allocation */
-    int cnt_removed_rows;
+    /* Make room for a new row under the row limit (again after the limit shrank), as the signer's bitmap does */
+    long long discarded_pks = verifier->discarded_pks;
+    while (verifier->active_rows + 1 > verifier->row_limit.limit) {
+        /* Number of removed rows in this pass */
+        int cnt_removed_rows;
 
-    /* This cleanup always removes rows that have been depleted. It is possible that many of such rows
+        /* This cleanup always removes rows that have been depleted. It is possible that many of such rows
      * exist in the matrix. Hence, optimizing the code by removing the row with fewest PKs only removes
      * a single row. Moreover, Removing one row each time, can increase the number of calls to clean up process.
      * We note that, considering the row with fewest PKs and remove any row with such number, is not a solution as
      * it might happen that our matrix has no row with zero and many with X PKs. Hence, the number of discard bits will
      * increase and is not desirable. */
-    if (!(cnt_removed_rows = mumhors_verifier_cleanup_rows(verifier))) {
-        /* No row was cleaned up. We perform the same policy as the signer by removing a/the row with
-         * the fewest number of PKs*/
-
-        /* Find the row the fewest number of pks to be deleted */
-        public_key_t *pk_row = verifier->pk_matrix.head;
-        public_key_t *target_row;
-        int max_seen_pks = verifier->c;
-
-        while (pk_row) {
-            if (pk_row->available_pks < max_seen_pks) {
-                max_seen_pks = pk_row->available_pks;
-                target_row = pk_row;
+        if (!(cnt_removed_rows = mumhors_verifier_cleanup_rows(verifier))) {
+            /* No row was cleaned up. We perform the same policy as the signer */
+            int victims[verifier->active_rows];
+            if (verifier->eviction_policy == EVICTION_FEWEST) {
+                /* The top of the eviction heap is the first row with the fewest number of pks */
+                long long number = verifier->eviction_heap.numbers[minheap_top(&verifier->eviction_heap)];
+                victims[0] = mumhors_verifier_window_position(verifier, number);
+                cnt_removed_rows = 1;
+            } else {
+                int counts[verifier->active_rows];
+                for (int position = 0; position < verifier->active_rows; position++)
+                    counts[position] = verifier->window_rows[position]->available_pks;
+                cnt_removed_rows = eviction_select(verifier->eviction_policy, verifier->eviction_param, counts,
+                                                   verifier->active_rows, victims);
             }
-            pk_row = pk_row->next;
-        }
-        /* The row is found. Delete the row */
-        mumhors_verifier_remove_row(verifier, target_row);
 
-        /* We only removed one row */
-        cnt_removed_rows = 1;
+            /* From the last victim, so the positions of the others stay valid */
+            for (int i = 0; i < cnt_removed_rows; i++)
+                mumhors_verifier_remove_row(verifier, victims[i]);
+        }
+        verifier->active_rows -= cnt_removed_rows;
+        mumhors_verifier_index_rebuild(verifier);
     }
 
     /* Add more rows virtually to the window. They are virtual as
      * rows are already in the memory. So we only add them to the list of active rows.*/
-    int possible_rows_to_add = min(cnt_removed_rows, verifier->r - verifier->nxt_row_number);
+    int possible_rows_to_add = verifier->row_limit.limit - verifier->active_rows;
+    if (verifier->r - verifier->nxt_row_number < possible_rows_to_add)
+        possible_rows_to_add = (int) (verifier->r - verifier->nxt_row_number);
     verifier->active_pks += possible_rows_to_add * verifier->c;
     verifier->nxt_row_number += possible_rows_to_add;
+    verifier->active_rows += possible_rows_to_add;
+    mumhors_verifier_index_rebuild(verifier);
+    row_limit_update(&verifier->row_limit, possible_rows_to_add, verifier->discarded_pks - discarded_pks, verifier->c);
+
+    /* The rows that entered the window join the eviction heap */
+    for (int position = verifier->active_rows - possible_rows_to_add; position < verifier->active_rows; position++) {
+        public_key_t *pk_row = verifier->window_rows[position];
+        pk_row->slot = verifier->free_slots[--verifier->free_count];
+        minheap_push(&verifier->eviction_heap, pk_row->slot, pk_row->available_pks, pk_row->number);
+    }
 
     return PKMATRIX_MORE_ROW_ALLOCATION_SUCCESS;
 }
@@ -415,17 +721,25 @@ static int mumhors_verifier_alloc_row_virtually(mumhors_verifier_t *verifier) {
 /// function virtual, is because the verifier virtually follows the signer's approach for verification without storing
 /// signer's bitmap data structure.
 /// \param verifier Pointer to MUMHORS verifier struct
-/// \param indices List of indices to be used for signature verification
+/// \param indices List of indices to be used for signature verification (in message order)
+/// \param sorted_indices The same indices in descending order, used for invalidating the public keys
 /// \param num_indices Number of passed indices
 /// \param signature Pointer to the signature
-/// \return VERIFY_SIGNATURE_INVALID or VERIFY_SIGNATURE_INVALID, or VERIFY_SIGNATURE_VALID
-static int verify_signature_using_virtual_matrix(mumhors_verifier_t *verifier, const int *indices, int num_indices,
+/// \return VERIFY_SIGNATURE_INVALID or VERIFY_SIGNATURE_VALID
+static int verify_signature_using_virtual_matrix(mumhors_verifier_t *verifier, const int *indices,
+                                                 const int *sorted_indices, int num_indices,
                                                  const unsigned char *signature) {
 
 
 
+    /* Extend the window with the headroom, as the signer's bitmap does */
     if (verifier->windows_size > verifier->active_pks) {
-        if (mumhors_verifier_alloc_row_virtually(verifier) == PKMATRIX_NO_MORE_ROWS_TO_ALLOCATE)
+        do {
+            if (mumhors_verifier_alloc_row_virtually(verifier) == PKMATRIX_NO_MORE_ROWS_TO_ALLOCATE)
+                break;
+        } while (verifier->active_pks <
+                 min(verifier->windows_size + verifier->headroom, (verifier->row_limit.limit - 1) * verifier->c));
+        if (verifier->windows_size > verifier->active_pks)
             return VERIFY_SIGNATURE_INVALID;
     }
 
@@ -445,13 +759,7 @@ static int verify_signature_using_virtual_matrix(mumhors_verifier_t *verifier, c
         int target_index = indices[i];
 
         /* Finding the row containing the target index */
-        public_key_t *pk_row = verifier->pk_matrix.head;
-        while (pk_row) {
-            if (target_index < pk_row->available_pks)
-                break;
-            target_index -= pk_row->available_pks;
-            pk_row = pk_row->next;
-        }
+        public_key_t *pk_row = verifier->window_rows[fenwick_find(&verifier->pks_index, &target_index)];
 
         /* The current row contains the public key. Find the public key */
         unsigned char *target_pk;
@@ -472,12 +780,12 @@ static int verify_signature_using_virtual_matrix(mumhors_verifier_t *verifier, c
         blake2b_256(sk_hash, sk, verifier->l / 8);
 
         /* Compare the hash with the current public key*/
-        if (strncmp(target_pk, sk_hash, SHA256_OUTPUT_LEN) != 0) {
-            free(sk);
+        if (memcmp(target_pk, sk_hash, SHA256_OUTPUT_LEN) != 0) {
             ver_status = 0;
             break;
         }
     }
+    free(sk);
 
 
     /* Sort the indices.
@@ -490,19 +798,13 @@ static int verify_signature_using_virtual_matrix(mumhors_verifier_t *verifier, c
      * we should maintain a data structure that returns back the actual order before sorting, or, first perform
      * fetching the values and then remove the indices.
      * */
-    /* First sort the indices */
+    /* The indices are invalidated in descending order, so no removal shifts a later index */
     for (int i = 0; i < num_indices; i++) {
-        int target_index = indices[i];
+        int target_index = sorted_indices[i];
 
         /* Invalidate the target index */
-        public_key_t *pk_row = verifier->pk_matrix.head;
-
-        while (pk_row) {
-            if (target_index < pk_row->available_pks)
-                break;
-            target_index -= pk_row->available_pks;
-            pk_row = pk_row->next;
-        }
+        int position = fenwick_find(&verifier->pks_index, &target_index);
+        public_key_t *pk_row = verifier->window_rows[position];
 
         for (int j = 0; j < verifier->c; j++) {
             if (pk_row->pks[j]) {
@@ -513,6 +815,8 @@ static int verify_signature_using_virtual_matrix(mumhors_verifier_t *verifier, c
                     pk_row->pks[j] = NULL;
                     pk_row->available_pks--;
                     verifier->active_pks--;
+                    fenwick_add(&verifier->pks_index, position, -1);
+                    minheap_decrease(&verifier->eviction_heap, pk_row->slot, 1);
                     break;
                 }
                 target_index--;
@@ -536,7 +840,7 @@ int mumhors_verify_signature(mumhors_verifier_t *verifier, const mumhors_signatu
 
     /* Extract the indices from the hash of the message while ensuring they are different
      * through a process known as rejection sampling. */
-    int *sorted_indices;
+    int sorted_indices[verifier->k];
     int verify_status;
 
 
@@ -544,19 +848,35 @@ int mumhors_verify_signature(mumhors_verifier_t *verifier, const mumhors_signatu
 #ifdef JOURNAL
     gettimeofday(&start_time, NULL);
 #endif
-    if (check_rejection_sampling(message, message_len, verifier->k, verifier->t, message_indices, signature->ctr,
-                                 &sorted_indices) == 0) {
-        verify_status = VERIFY_SIGNATURE_INVALID;
-                                 }
+    int rejection_sampling_status = check_rejection_sampling(message, message_len, verifier->k, verifier->t,
+                                                             message_indices, signature->stage, signature->ctr,
+                                                             sorted_indices);
 #ifdef JOURNAL
     gettimeofday(&end_time, NULL);
     mumhors_verify_time += (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_usec - start_time.tv_usec) / 1.0e6;
+    verifier->rs_stats.sampling_time += (end_time.tv_sec - start_time.tv_sec) + (
+        end_time.tv_usec - start_time.tv_usec) / 1.0e6;
+    struct timeval checking_end_time = end_time, verify_end_time;
 #endif
 
-    verify_status = verify_signature_using_virtual_matrix(verifier, message_indices, verifier->k,
-                                                          signature->signature);
+    /* Reject before the window is touched, so an invalid signature does not consume any public key */
+    if (!rejection_sampling_status) {
+        verifier->rs_stats.rejected++;
+        verify_status = VERIFY_SIGNATURE_INVALID;
+    } else {
+        rs_stats_record(&verifier->rs_stats, signature->stage, signature->ctr);
+        verify_status = verify_signature_using_virtual_matrix(verifier, message_indices, sorted_indices,
+                                                              verifier->k, signature->signature);
+        if (verify_status == VERIFY_SIGNATURE_VALID)
+            verifier->signatures++;
+    }
+
+#ifdef JOURNAL
+    gettimeofday(&verify_end_time, NULL);
+    verifier->rs_stats.other_time += (verify_end_time.tv_sec - checking_end_time.tv_sec) + (
+        verify_end_time.tv_usec - checking_end_time.tv_usec) / 1.0e6;
+#endif
 
     free(message_indices);
-    free(sorted_indices);
     return verify_status;
 }
@@ -13,10 +13,60 @@
 #define SIGN_SUCCESS 0
 #define SIGN_NO_MORE_ROW_FAILED 1
 
+#define MUMHORS_INIT_SUCCESS 0
+#define MUMHORS_INIT_FAILED 1
+
+/* The private key of a cell of the matrix is the hash of the seed, the row number (8 bytes) and the column number
+ * (4 bytes), in the byte order of the machine */
+#define SK_ROW_BYTES 8
+#define SK_COL_BYTES 4
+
+/* Stages of the rejection sampling (which derivation produced the distinct indices) */
+#define RS_STAGE_HASH 0 /* Hash of the message */
+#define RS_STAGE_PAD1 1 /* Hash XORed with the first pad */
+#define RS_STAGE_PAD2 2 /* Hash XORed with the first two pads */
+#define RS_STAGE_PAD3 3 /* Hash XORed with all three pads */
+#define RS_STAGE_CTR 4 /* Hash of the padded hash and the counter */
+
+/* Pads XORed (cumulatively) into the message hash by the pad stages of the rejection sampling */
+#define RS_NUM_PADS 3
+extern const unsigned char mumhors_rs_pads[RS_NUM_PADS][32];
+
+/* Number of log2 buckets of the attempts histogram (bucket b counts messages with 2^b to 2^(b+1)-1 attempts) */
+#define RS_ATTEMPT_HISTOGRAM_BUCKETS 34
+
+/// Rejection sampling telemetry. The attempts of a message are the number of derivations the signer tried:
+/// 1 for RS_STAGE_HASH, 2-4 for the pad stages and 5 + ctr for RS_STAGE_CTR. The verifier records the attempts
+/// implied by the stage and counter of each signature it accepts in the rejection check.
+typedef struct mumhors_rs_stats {
+    unsigned long long messages; /* Number of sampled (signer) or successfully checked (verifier) messages */
+    unsigned long long rejected; /* Number of signatures that failed the rejection check (verifier) */
+    unsigned long long stage_hits[RS_STAGE_CTR + 1]; /* Number of messages per successful stage */
+    unsigned long long attempts; /* Total number of attempts */
+    unsigned long long attempt_histogram[RS_ATTEMPT_HISTOGRAM_BUCKETS]; /* Histogram of attempts per message */
+    unsigned int max_ctr; /* Largest counter seen */
+    double sampling_time; /* Seconds spent in rejection sampling/checking (JOURNAL builds only) */
+    double other_time; /* Seconds spent in the rest of signing/verification (JOURNAL builds only) */
+} mumhors_rs_stats_t;
+
+/// Remaining capacity of a signer or a verifier. The keys of the allocated rows are the keys of the window, the used
+/// keys and the discarded keys, so every field follows from the counters of the window and of the signatures in
+/// constant time.
+typedef struct mumhors_capacity {
+    long long signatures; /* Signatures issued (signer) or accepted (verifier) */
+    long long used_keys; /* Keys taken by the signatures (k per signature, a failed one included) */
+    long long window_keys; /* Available keys in the rows of the window */
+    long long unallocated_keys; /* Keys of the rows that have not entered the window yet */
+    long long discarded_keys; /* Available keys of the evicted rows (never used) */
+    double discard_rate; /* Discarded keys per signature so far */
+    long long remaining_signatures; /* Estimate of the signatures left (0 once the keys are exhausted) */
+} mumhors_capacity_t;
+
 /// Struct for MUMHORS signature
 typedef struct mumhors_signature {
     unsigned char *signature; /* Signature of the message signed by the signer */
-    unsigned int ctr; /* Weak message counter */
+    unsigned int ctr; /* Weak message counter (0 unless stage is RS_STAGE_CTR) */
+    unsigned char stage; /* Rejection sampling stage that produced the indices */
 } mumhors_signature_t;
 
 /// Struct for MUMHORS signer
@@ -27,15 +77,18 @@ typedef struct mumhors_signer {
     int k; /* HORS k parameter */
     int l; /* HORS l parameter */
     int rt; /* Bitmap threshold (maximum) rows to allocate */
-    int r; /* Number of bitmap matrix rows */
+    long long r; /* Number of bitmap matrix rows */
     bitmap_t bm; /* Bitmap for managing the private key utilization */
     mumhors_signature_t signature; /* Signature of the message signed by the signer */
+    long long signatures; /* Signatures issued (mumhors_sign_message returned SIGN_SUCCESS) */
+    mumhors_rs_stats_t rs_stats; /* Rejection sampling telemetry */
 } mumhors_signer_t;
 
 /// Public key node
 typedef struct public_key {
     int available_pks; /* Number of available public keys */
-    int number; /* Public key row number */
+    long long number; /* Public key row number */
+    int slot; /* Id of the row in the verifier's eviction heap while the row is in the window */
     unsigned char **pks; /* An array of public keys */
     struct public_key *next; /* Pointer to the next row of the matrix */
 } public_key_t;
@@ -51,16 +104,38 @@ typedef struct mumhors_verifier {
     int t; /* HORS t parameter */
     int k; /* HORS k parameter */
     int l; /* HORS l parameter */
-    int r; /* Total number of rows in public key matrix (=MUMHORS parameter l)*/
+    long long r; /* Total number of rows in public key matrix (=MUMHORS parameter l)*/
     int c; /* Number of columns in public key matrix (=HORS parameter t)*/
     int rt; /* Maximum rows to consider the matrix at a time */
-    int active_pks; /* Number of available public keys in the active rows */
+    long long active_pks; /* Number of available public keys in the active rows */
     int windows_size; /* Size of the window (#PKs) required for each operation. Same as Bitmap window size */
-    int nxt_row_number; /* Next row number for allocating new row */
+    long long nxt_row_number; /* Next row number for allocating new row */
+    int active_rows; /* Number of rows in the window (the first rows of the public key matrix) */
+    public_key_t **window_rows; /* Rows of the window in order (the positions of the Fenwick tree) */
+    fenwick_t pks_index; /* Fenwick tree over the available public keys of the window rows */
+    minheap_t eviction_heap; /* Window rows by available public keys, for eviction and depleted row detection */
+    int eviction_policy; /* Rows evicted from a full window without depleted rows (same as the signer's bitmap) */
+    int eviction_param; /* Parameter of the eviction policy */
+    long long discarded_pks; /* Available public keys of the evicted rows */
+    long long discarded_rows; /* Number of evicted rows */
+    row_limit_t row_limit; /* Number of rows the window may hold (same as the signer's bitmap) */
+    int headroom; /* Public keys beyond the window size that an extension tops the window up to */
+    int *free_slots; /* Heap ids of the removed rows, reused by the rows entering the window */
+    int free_count; /* Number of free heap ids */
     public_key_matrix_t pk_matrix; /* Matrix (linked list) of public keys */
+    long long signatures; /* Signatures accepted (mumhors_verify_signature returned VERIFY_SIGNATURE_VALID) */
+    mumhors_rs_stats_t rs_stats; /* Rejection sampling telemetry */
 } mumhors_verifier_t;
 
 
+/// Computes the message digest that the rejection sampling starts from. It is Blake2b-256, or with
+/// -DMESSAGE_DIGEST_TREE, the Blake2b tree hash (BLAKE2bp by default) for messages of at least
+/// MESSAGE_DIGEST_TREE_MIN_LEN bytes. The signer and the verifier must be built with the same mode.
+/// \param digest Buffer for the 32-byte digest
+/// \param message Pointer to the message
+/// \param message_len Message's length
+void mumhors_message_digest(unsigned char *digest, const unsigned char *message, long message_len);
+
 /// Public key generator of the MUMHORS. In MUMHORS the private keys are generated from seed on fly during signing.
 /// Hence, there is no need to generate a list of private keys as this consumes storage and is not efficient.
 /// \param pk_matrix Pointer to the public key matrix struct
@@ -68,7 +143,7 @@ typedef struct mumhors_verifier {
 /// \param seed_len Size of the seed in terms of bytes
 /// \param row Number of matrix rows
 /// \param col Number of matrix columns
-void mumhors_pk_gen(public_key_matrix_t *pk_matrix, const unsigned char *seed, int seed_len, int row, int col);
+void mumhors_pk_gen(public_key_matrix_t *pk_matrix, const unsigned char *seed, int seed_len, long long row, int col);
 
 /// Initializes a new MUMHORS signer
 /// \param signer Pointer to MUMHORS signer struct
@@ -77,10 +152,35 @@ void mumhors_pk_gen(public_key_matrix_t *pk_matrix, const unsigned char *seed, i
 /// \param t HORS t parameter
 /// \param k HORS k parameter
 /// \param l HORS l parameter
-/// \param rt Bitmap threshold(maximum) rows to allocate
+/// \param rt Bitmap threshold(maximum) rows to allocate (see row_threshold_autotune, the verifier must get the same one)
 /// \param r Number of bitmap matrix rows
-void mumhors_init_signer(mumhors_signer_t *signer, unsigned char *seed, int seed_len,
-                         int t, int k, int l, int rt, int r);
+/// \param engine Bitmap engine storing the rows (NULL for BITMAP_DEFAULT_ENGINE)
+/// \return MUMHORS_INIT_SUCCESS or MUMHORS_INIT_FAILED (rt rows of t keys exceed BITMAP_MAX_WINDOW_BITS or an
+/// allocation failed, the signer is left uninitialized)
+int mumhors_init_signer(mumhors_signer_t *signer, unsigned char *seed, int seed_len,
+                        int t, int k, int l, int rt, long long r, const bitmap_engine_t *engine);
+
+/// Sets the eviction policy of the signer's bitmap (EVICTION_FEWEST by default). It must be set before the first
+/// signature, with the same policy and parameter as the verifier (see mumhors_verifier_set_eviction).
+/// \param signer Pointer to MUMHORS signer struct
+/// \param policy Policy id (EVICTION_*)
+/// \param param Parameter of the policy (see eviction.h)
+void mumhors_signer_set_eviction(mumhors_signer_t *signer, int policy, int param);
+
+/// Makes the row limit of the signer's bitmap adaptive between min_rows and rt (see row_limit.h). It must be set
+/// before the first signature, with the same parameters as the verifier (see mumhors_verifier_set_row_limit).
+/// \param signer Pointer to MUMHORS signer struct
+/// \param min_rows Smallest limit (rt keeps the limit fixed)
+/// \param target Discard rate target, per mille
+/// \param epoch Rows entering the window between two adjustments
+void mumhors_signer_set_row_limit(mumhors_signer_t *signer, int min_rows, int target, int epoch);
+
+/// Sets the run of signatures that one extension of the signer's window makes room for (1 by default, an extension
+/// after every signature that needs it). A run of up to t / k signatures is served by one window extension. It must be
+/// set before the first signature, with the same run as the verifier (see mumhors_verifier_set_extension_run).
+/// \param signer Pointer to MUMHORS signer struct
+/// \param signatures Signatures of a run (at least 1)
+void mumhors_signer_set_extension_run(mumhors_signer_t *signer, int signatures);
 
 /// Deletes the MUMHORS signer struct
 /// \param signer Pointer to MUMHORS signer struct
@@ -94,20 +194,71 @@ void mumhors_delete_signer(mumhors_signer_t *signer);
 /// \param l HORS l parameter
 /// \param r Number of rows in the public key matrix
 /// \param c Number of columns in the public key matrix
-/// \param rt Maximum number of rows to consider in its window
+/// \param rt Maximum number of rows to consider in its window (the signer's row threshold)
 /// \param window_size Size of the window required for each operation
-void mumhors_init_verifier(mumhors_verifier_t *verifier, public_key_matrix_t pk_matrix, int t, int k, int l,
-                           int r, int c, int rt, int window_size);
+/// \return MUMHORS_INIT_SUCCESS or MUMHORS_INIT_FAILED (rt rows of c keys exceed BITMAP_MAX_WINDOW_BITS or an
+/// allocation failed, the verifier is left uninitialized and the public keys stay with the caller)
+int mumhors_init_verifier(mumhors_verifier_t *verifier, public_key_matrix_t pk_matrix, int t, int k, int l,
+                          long long r, int c, int rt, int window_size);
+
+/// Sets the eviction policy of the verifier (EVICTION_FEWEST by default). It must be set before the first
+/// verification, with the same policy and parameter as the signer.
+/// \param verifier Pointer to MUMHORS verifier struct
+/// \param policy Policy id (EVICTION_*)
+/// \param param Parameter of the policy (see eviction.h)
+void mumhors_verifier_set_eviction(mumhors_verifier_t *verifier, int policy, int param);
+
+/// Makes the row limit of the verifier adaptive between min_rows and rt (see row_limit.h). It must be set before the
+/// first verification, with the same parameters as the signer.
+/// \param verifier Pointer to MUMHORS verifier struct
+/// \param min_rows Smallest limit (rt keeps the limit fixed)
+/// \param target Discard rate target, per mille
+/// \param epoch Rows entering the window between two adjustments
+void mumhors_verifier_set_row_limit(mumhors_verifier_t *verifier, int min_rows, int target, int epoch);
+
+/// Sets the run of signatures that one extension of the verifier's window makes room for (1 by default). It must be
+/// set before the first verification, with the same run as the signer.
+/// \param verifier Pointer to MUMHORS verifier struct
+/// \param signatures Signatures of a run (at least 1)
+void mumhors_verifier_set_extension_run(mumhors_verifier_t *verifier, int signatures);
 
 /// Deletes the MUMHORS verifier struct
 /// \param verifier Pointer to MUMHORS verifier struct
-void mumhors_delete_verifier(const mumhors_verifier_t *verifier);
+void mumhors_delete_verifier(mumhors_verifier_t *verifier);
 
 #ifdef JOURNAL
 /* Reports aggregated timing collected when JOURNAL is enabled */
-void mumhors_report_time(int total_tests);
+void mumhors_report_time(long long total_tests);
+
+/// Presents a report of the rejection sampling telemetry
+/// \param title Title of the report
+/// \param stats Pointer to the telemetry
+void mumhors_report_rs_stats(const char *title, const mumhors_rs_stats_t *stats);
 #endif
 
+/// Returns the rejection sampling telemetry of the signer
+/// \param signer Pointer to MUMHORS signer struct
+/// \param stats Pointer to the struct which will store the telemetry
+void mumhors_signer_rs_stats(const mumhors_signer_t *signer, mumhors_rs_stats_t *stats);
+
+/// Returns the rejection sampling telemetry of the verifier
+/// \param verifier Pointer to MUMHORS verifier struct
+/// \param stats Pointer to the struct which will store the telemetry
+void mumhors_verifier_rs_stats(const mumhors_verifier_t *verifier, mumhors_rs_stats_t *stats);
+
+/// Returns the remaining capacity of the signer. Its signatures left are estimated from the keys each signature has
+/// taken so far (k, plus the discard rate), until the keys left cannot fill a window. It only reads counters, so it
+/// can be polled under full signing load (from the signing thread, or under the lock that guards the signer).
+/// \param signer Pointer to MUMHORS signer struct
+/// \param capacity Pointer to the struct which will store the capacity
+void mumhors_signer_capacity(const mumhors_signer_t *signer, mumhors_capacity_t *capacity);
+
+/// Returns the remaining capacity of the verifier (see mumhors_signer_capacity). In lockstep with the signer, both
+/// report the same capacity.
+/// \param verifier Pointer to MUMHORS verifier struct
+/// \param capacity Pointer to the struct which will store the capacity
+void mumhors_verifier_capacity(const mumhors_verifier_t *verifier, mumhors_capacity_t *capacity);
+
 /// Sign the message
 /// \param signer Pointer to MUMHORS signer struct
 /// \param message Pointer to the message to be signed
@@ -121,7 +272,7 @@ int mumhors_sign_message(mumhors_signer_t *signer, const unsigned char *message,
 /// \param signature Pointer to the signature
 /// \param message Pointer to the message
 /// \param message_len Message's length
-/// \return
+/// \return VERIFY_SIGNATURE_VALID or VERIFY_SIGNATURE_INVALID
 int mumhors_verify_signature(mumhors_verifier_t *verifier, const mumhors_signature_t *signature,
                              const unsigned char *message, int message_len);
 #endif
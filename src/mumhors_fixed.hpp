@@ -0,0 +1,580 @@
+#ifndef MUMHORS_FIXED_HPP
+#define MUMHORS_FIXED_HPP
+
+/* Header-only C++ layer with the MUM-HORS parameters (t, k, l, rt) as template parameters. Index extraction,
+ * sorting, row scans and key derivation are fully unrolled for the given parameter set, and the bitmap is sized
+ * at compile time. The window only implements the default settings of the C signer/verifier: fewest eviction, a
+ * fixed row limit of rt rows and runs of one signature (no headroom). With those, signatures and verification
+ * results are identical to the generic C signer/verifier of src/mumhors.c, and the factories return nullptr for
+ * any other setting. */
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+extern "C" {
+#include "mumhors.h"
+#include "hash.h"
+#include "mumhors_math.h"
+}
+
+namespace mumhors {
+
+/// Compile-time parameter set
+/// \tparam T HORS t parameter (power of two, at least 64)
+/// \tparam K HORS k parameter
+/// \tparam L HORS l parameter (size of a private key in bits)
+/// \tparam RT Bitmap threshold (maximum) rows to allocate
+template<int T, int K, int L, int RT>
+struct fixed_params {
+    static_assert(T >= 64 && std::has_single_bit(static_cast<unsigned>(T)), "t must be a power of two >= 64");
+    static_assert(K >= 2 && RT >= 1, "k and rt must be positive");
+    static_assert(L == 8 * SHA256_OUTPUT_LEN, "each private key is a Blake2b-256 output");
+
+    static constexpr int t = T;
+    static constexpr int k = K;
+    static constexpr int l = L;
+    static constexpr int rt = RT;
+    static constexpr int index_bits = std::countr_zero(static_cast<unsigned>(T));
+    static constexpr int words = T / 64;
+
+    static_assert(K * index_bits <= 8 * SHA256_OUTPUT_LEN, "k indices must fit in one hash");
+};
+
+namespace detail {
+
+/// Number of comparators of Batcher's odd-even merge sort network for n inputs
+constexpr int sort_network_size(int n) {
+    int size = 0;
+    for (int p = 1; p < n; p <<= 1)
+        for (int q = p; q >= 1; q >>= 1)
+            for (int j = q % p; j + q < n; j += 2 * q)
+                for (int i = 0; i < q && i + j + q < n; i++)
+                    if ((i + j) / (2 * p) == (i + j + q) / (2 * p))
+                        size++;
+    return size;
+}
+
+/// Comparators of Batcher's odd-even merge sort network for N inputs
+template<int N>
+constexpr std::array<std::pair<int, int>, sort_network_size(N)> sort_network() {
+    std::array<std::pair<int, int>, sort_network_size(N)> network{};
+    int size = 0;
+    for (int p = 1; p < N; p <<= 1)
+        for (int q = p; q >= 1; q >>= 1)
+            for (int j = q % p; j + q < N; j += 2 * q)
+                for (int i = 0; i < q && i + j + q < N; i++)
+                    if ((i + j) / (2 * p) == (i + j + q) / (2 * p))
+                        network[size++] = {i + j, i + j + q};
+    return network;
+}
+
+/// Sorts the array in descending order with an unrolled sorting network
+template<int N>
+inline void sort_descending(std::array<int, N> &values) {
+    static constexpr auto network = sort_network<N>();
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        ((values[network[I].first] < values[network[I].second]
+              ? std::swap(values[network[I].first], values[network[I].second])
+              : void()), ...);
+    }(std::make_index_sequence<network.size()>{});
+}
+
+/// Extracts the k indices of the hash (index_bits each, most significant bit first) and checks that they are
+/// distinct. Same result as check_if_indices_are_distinct of the C signer.
+/// \param value Hash to extract the indices from
+/// \param message_indices Indices in message order
+/// \param sorted_indices Indices in descending order
+/// \return true if the indices are distinct
+template<typename P>
+inline bool extract_distinct_indices(const unsigned char *value, std::array<int, P::k> &message_indices,
+                                     std::array<int, P::k> &sorted_indices) {
+    /* Zero padded copy, so every index can be read with one 8-byte load */
+    unsigned char padded[SHA256_OUTPUT_LEN + 8] = {};
+    std::memcpy(padded, value, SHA256_OUTPUT_LEN);
+
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        ((message_indices[I] = [&] {
+            constexpr int start_bit = static_cast<int>(I) * P::index_bits;
+            std::uint64_t window = 0;
+            for (int b = 0; b < 8; b++)
+                window = window << 8 | padded[start_bit / 8 + b];
+            return static_cast<int>((window >> (64 - start_bit % 8 - P::index_bits)) & (P::t - 1));
+        }()), ...);
+    }(std::make_index_sequence<P::k>{});
+
+    sorted_indices = message_indices;
+    sort_descending<P::k>(sorted_indices);
+
+    return [&]<std::size_t... I>(std::index_sequence<I...>) {
+        return ((sorted_indices[I] != sorted_indices[I + 1]) && ...);
+    }(std::make_index_sequence<P::k - 1>{});
+}
+
+/// Rejection sampling of the signer (same ladder as perform_rejection_sampling of the C signer)
+/// \return The successful stage
+template<typename P>
+inline int perform_rejection_sampling(const unsigned char *message, int message_len,
+                                      std::array<int, P::k> &message_indices, std::array<int, P::k> &sorted_indices,
+                                      unsigned int &ctr) {
+    ctr = 0;
+    unsigned char hash[SHA256_OUTPUT_LEN];
+    mumhors_message_digest(hash, message, message_len);
+    if (extract_distinct_indices<P>(hash, message_indices, sorted_indices))
+        return RS_STAGE_HASH;
+
+    for (int j = 0; j < RS_NUM_PADS; j++) {
+        for (int i = 0; i < SHA256_OUTPUT_LEN; i++)
+            hash[i] ^= mumhors_rs_pads[j][i];
+        if (extract_distinct_indices<P>(hash, message_indices, sorted_indices))
+            return RS_STAGE_PAD1 + j;
+    }
+
+    /* Four counters per multi-buffer hash, the smallest passing one wins */
+    constexpr int lanes = 4;
+    unsigned char buffers[lanes][SHA256_OUTPUT_LEN + sizeof(unsigned int)];
+    unsigned char hashes[lanes][SHA256_OUTPUT_LEN];
+    const unsigned char *inputs[lanes];
+    unsigned char *outputs[lanes];
+    for (int lane = 0; lane < lanes; lane++) {
+        std::memcpy(buffers[lane], hash, SHA256_OUTPUT_LEN);
+        inputs[lane] = buffers[lane];
+        outputs[lane] = hashes[lane];
+    }
+    for (unsigned int candidate = 0;; candidate += lanes) {
+        for (int lane = 0; lane < lanes; lane++) {
+            unsigned int candidate_ctr = candidate + lane;
+            std::memcpy(buffers[lane] + SHA256_OUTPUT_LEN, &candidate_ctr, sizeof(candidate_ctr));
+        }
+        blake2b_256_multi(outputs, inputs, SHA256_OUTPUT_LEN + sizeof(unsigned int), lanes);
+        for (int lane = 0; lane < lanes; lane++) {
+            if (extract_distinct_indices<P>(hashes[lane], message_indices, sorted_indices)) {
+                ctr = candidate + lane;
+                return RS_STAGE_CTR;
+            }
+        }
+    }
+}
+
+/// Checks the rejection sampling of a signature (same rules as check_rejection_sampling of the C verifier)
+/// \return true if the derivation of the recorded stage yields distinct indices
+template<typename P>
+inline bool check_rejection_sampling(const unsigned char *message, int message_len, unsigned char stage,
+                                     unsigned int ctr, std::array<int, P::k> &message_indices,
+                                     std::array<int, P::k> &sorted_indices) {
+    if (stage > RS_STAGE_CTR || (stage != RS_STAGE_CTR && ctr != 0))
+        return false;
+
+    unsigned char hash_ctr_buffer[SHA256_OUTPUT_LEN + sizeof(unsigned int)];
+    mumhors_message_digest(hash_ctr_buffer, message, message_len);
+
+    int num_pads = stage < RS_STAGE_CTR ? stage : RS_NUM_PADS;
+    for (int j = 0; j < num_pads; j++)
+        for (int i = 0; i < SHA256_OUTPUT_LEN; i++)
+            hash_ctr_buffer[i] ^= mumhors_rs_pads[j][i];
+
+    if (stage != RS_STAGE_CTR)
+        return extract_distinct_indices<P>(hash_ctr_buffer, message_indices, sorted_indices);
+
+    unsigned char target_hash[SHA256_OUTPUT_LEN];
+    std::memcpy(hash_ctr_buffer + SHA256_OUTPUT_LEN, &ctr, sizeof(ctr));
+    blake2b_256(target_hash, hash_ctr_buffer, sizeof(hash_ctr_buffer));
+    return extract_distinct_indices<P>(target_hash, message_indices, sorted_indices);
+}
+
+/// Window of at most RT rows of T bits. Column c of a row is bit c % 64 of word c / 64. The rows are kept in
+/// window order through a small array of slot numbers, so removing a row moves no bit data.
+template<typename P, typename Payload>
+class fixed_window {
+public:
+    struct row {
+        std::array<std::uint64_t, P::words> words; /* Available columns */
+        long long number; /* Row number */
+        int set_bits; /* Number of available columns */
+        Payload payload; /* Per-row data of the owner */
+    };
+
+    fixed_window() {
+        for (int i = 0; i < P::rt; i++)
+            free_slots_[i] = static_cast<std::uint16_t>(P::rt - 1 - i);
+    }
+
+    /// Appends a full row at the end of the window
+    row &append(long long number) {
+        std::uint16_t slot = free_slots_[--num_free_];
+        order_[active_rows_++] = slot;
+        row &new_row = slots_[slot];
+        new_row.words.fill(~0ULL);
+        new_row.number = number;
+        new_row.set_bits = P::t;
+        set_bits_ += P::t;
+        return new_row;
+    }
+
+    /// Removes the row at the given window position
+    void remove(int position) {
+        set_bits_ -= slots_[order_[position]].set_bits;
+        free_slots_[num_free_++] = order_[position];
+        for (int i = position; i + 1 < active_rows_; i++)
+            order_[i] = order_[i + 1];
+        active_rows_--;
+    }
+
+    /// Removes every row without set bits
+    /// \return Number of removed rows
+    int remove_empty_rows() {
+        int kept = 0;
+        for (int i = 0; i < active_rows_; i++) {
+            if (slots_[order_[i]].set_bits)
+                order_[kept++] = order_[i];
+            else
+                free_slots_[num_free_++] = order_[i];
+        }
+        int removed = active_rows_ - kept;
+        active_rows_ = kept;
+        return removed;
+    }
+
+    /// Returns the position of the first row with the fewest set bits
+    int position_of_fewest_set_bits() const {
+        int target = 0;
+        for (int i = 1; i < active_rows_; i++)
+            if (slots_[order_[i]].set_bits < slots_[order_[target]].set_bits)
+                target = i;
+        return target;
+    }
+
+    /// Finds the row and column of the index'th set bit of the window
+    row &select(int index, int &col) {
+        row *target = &slots_[order_[0]];
+        for (int i = 0; i < active_rows_; i++) {
+            target = &slots_[order_[i]];
+            if (index < target->set_bits)
+                break;
+            index -= target->set_bits;
+        }
+        col = 0;
+        [&]<std::size_t... W>(std::index_sequence<W...>) {
+            (void) ((index < std::popcount(target->words[W])
+                         ? (col = static_cast<int>(W) * 64 + word_select(target->words[W], index), true)
+                         : (index -= std::popcount(target->words[W]), false)) || ...);
+        }(std::make_index_sequence<P::words>{});
+        return *target;
+    }
+
+    /// Clears a column of a row
+    void clear(row &target, int col) {
+        target.words[col / 64] &= ~(1ULL << (col % 64));
+        target.set_bits--;
+        set_bits_--;
+    }
+
+    row &at(int position) { return slots_[order_[position]]; }
+    int active_rows() const { return active_rows_; }
+    int set_bits() const { return set_bits_; }
+
+private:
+    std::array<row, P::rt> slots_{};
+    std::array<std::uint16_t, P::rt> order_{}; /* Slot of each window position */
+    std::array<std::uint16_t, P::rt> free_slots_{};
+    int num_free_ = P::rt;
+    int active_rows_ = 0;
+    int set_bits_ = 0;
+};
+
+struct no_payload {
+};
+
+} // namespace detail
+
+/// Type-erased signer, implemented by fixed_signer for each parameter set
+class signer_interface {
+public:
+    virtual ~signer_interface() = default;
+
+    /// Sign the message
+    /// \return SIGN_SUCCESS or SIGN_NO_MORE_ROW_FAILED
+    virtual int sign(const unsigned char *message, int message_len) = 0;
+
+    /// Signature of the last signed message
+    virtual const mumhors_signature_t &signature() const = 0;
+};
+
+/// Type-erased verifier, implemented by fixed_verifier for each parameter set
+class verifier_interface {
+public:
+    virtual ~verifier_interface() = default;
+
+    /// Verifies the signature on the given message
+    /// \return VERIFY_SIGNATURE_VALID or VERIFY_SIGNATURE_INVALID
+    virtual int verify(const mumhors_signature_t &signature, const unsigned char *message, int message_len) = 0;
+};
+
+/// MUM-HORS signer specialized for one parameter set
+template<typename P>
+class fixed_signer final : public signer_interface {
+public:
+    /// \param seed Seed to generate the private keys and signatures
+    /// \param seed_len Size of the seed in terms of bytes
+    /// \param r Number of bitmap matrix rows
+    fixed_signer(const unsigned char *seed, int seed_len, long long r)
+        : seed_len_(seed_len), r_(r), seeds_(P::k * (seed_len + SK_ROW_BYTES + SK_COL_BYTES)) {
+        /* Every private key is derived from seed || row || col. The seed part is written once. */
+        for (int i = 0; i < P::k; i++)
+            std::memcpy(&seeds_[i * (seed_len + SK_ROW_BYTES + SK_COL_BYTES)], seed, seed_len);
+
+        for (int i = 0; i < P::rt; i++)
+            window_.append(i);
+        nxt_row_number_ = P::rt;
+
+        signature_.signature = signature_buffer_.data();
+        signature_.ctr = 0;
+        signature_.stage = RS_STAGE_HASH;
+    }
+
+    int sign(const unsigned char *message, int message_len) override {
+        std::array<int, P::k> message_indices, sorted_indices;
+        signature_.stage = detail::perform_rejection_sampling<P>(message, message_len, message_indices,
+                                                                 sorted_indices, signature_.ctr);
+
+        /* Locate all the indices first, then derive the k private keys with the multi-buffer hash */
+        const unsigned char *inputs[P::k];
+        unsigned char *outputs[P::k];
+        for (int i = 0; i < P::k; i++) {
+            int col;
+            long long row_number = window_.select(message_indices[i], col).number;
+            unsigned char *seed = &seeds_[i * (seed_len_ + SK_ROW_BYTES + SK_COL_BYTES)];
+            std::memcpy(seed + seed_len_, &row_number, SK_ROW_BYTES);
+            std::memcpy(seed + seed_len_ + SK_ROW_BYTES, &col, SK_COL_BYTES);
+            inputs[i] = seed;
+            outputs[i] = signature_buffer_.data() + i * SHA256_OUTPUT_LEN;
+        }
+        blake2b_256_multi(outputs, inputs, seed_len_ + SK_ROW_BYTES + SK_COL_BYTES, P::k);
+
+        /* Unset in descending order, so no removal shifts a later index */
+        for (int i = 0; i < P::k; i++) {
+            int col;
+            auto &row = window_.select(sorted_indices[i], col);
+            window_.clear(row, col);
+        }
+
+        if (P::t > window_.set_bits() && !allocate_more_rows())
+            return SIGN_NO_MORE_ROW_FAILED;
+        return SIGN_SUCCESS;
+    }
+
+    const mumhors_signature_t &signature() const override { return signature_; }
+
+private:
+    /// Same policy as the extension of the C bitmap with the default settings: drop the empty rows (or the row with
+    /// the fewest set bits) and fill the window up to rt rows
+    bool allocate_more_rows() {
+        if (nxt_row_number_ >= r_)
+            return false;
+        if (window_.active_rows() + 1 > P::rt && !window_.remove_empty_rows())
+            window_.remove(window_.position_of_fewest_set_bits());
+
+        int possible_number_of_rows = static_cast<int>(
+            std::min<long long>(P::rt - window_.active_rows(), r_ - nxt_row_number_));
+        for (int i = 0; i < possible_number_of_rows; i++)
+            window_.append(nxt_row_number_++);
+        return true;
+    }
+
+    int seed_len_;
+    long long r_;
+    long long nxt_row_number_;
+    std::vector<unsigned char> seeds_;
+    detail::fixed_window<P, detail::no_payload> window_;
+    std::array<unsigned char, P::k * SHA256_OUTPUT_LEN> signature_buffer_{};
+    mumhors_signature_t signature_{};
+};
+
+/// MUM-HORS verifier specialized for one parameter set. It takes the ownership of the public key matrix and,
+/// like the C verifier, frees the public keys as they are used.
+template<typename P>
+class fixed_verifier final : public verifier_interface {
+public:
+    /// \param pk_matrix Matrix (linked list) of public keys, with r rows of t public keys
+    /// \param r Number of rows in the public key matrix
+    fixed_verifier(public_key_matrix_t pk_matrix, long long r) : r_(r), next_pk_row_(pk_matrix.head) {
+        for (int i = 0; i < P::rt; i++)
+            append_next_pk_row();
+    }
+
+    ~fixed_verifier() override {
+        for (int i = 0; i < window_.active_rows(); i++)
+            free_pk_row(window_.at(i).payload);
+        while (next_pk_row_) {
+            public_key_t *pk_row = next_pk_row_;
+            next_pk_row_ = next_pk_row_->next;
+            free_pk_row(pk_row);
+        }
+    }
+
+    fixed_verifier(const fixed_verifier &) = delete;
+    fixed_verifier &operator=(const fixed_verifier &) = delete;
+
+    int verify(const mumhors_signature_t &signature, const unsigned char *message, int message_len) override {
+        std::array<int, P::k> message_indices, sorted_indices;
+        if (!detail::check_rejection_sampling<P>(message, message_len, signature.stage, signature.ctr,
+                                                 message_indices, sorted_indices))
+            return VERIFY_SIGNATURE_INVALID;
+
+        if (P::t > window_.set_bits() && !allocate_row_virtually())
+            return VERIFY_SIGNATURE_INVALID;
+
+        /* Hash the k private keys of the signature at once */
+        unsigned char sk_hashes[P::k][SHA256_OUTPUT_LEN];
+        const unsigned char *inputs[P::k];
+        unsigned char *outputs[P::k];
+        for (int i = 0; i < P::k; i++) {
+            inputs[i] = signature.signature + i * SHA256_OUTPUT_LEN;
+            outputs[i] = sk_hashes[i];
+        }
+        blake2b_256_multi(outputs, inputs, SHA256_OUTPUT_LEN, P::k);
+
+        bool valid = true;
+        for (int i = 0; i < P::k && valid; i++) {
+            int col;
+            auto &row = window_.select(message_indices[i], col);
+            valid = std::memcmp(row.payload->pks[col], sk_hashes[i], SHA256_OUTPUT_LEN) == 0;
+        }
+
+        /* The signer consumed the keys whether or not the signature survived the transmission */
+        for (int i = 0; i < P::k; i++) {
+            int col;
+            auto &row = window_.select(sorted_indices[i], col);
+            std::free(row.payload->pks[col]);
+            row.payload->pks[col] = nullptr;
+            row.payload->available_pks--;
+            window_.clear(row, col);
+        }
+
+        return valid ? VERIFY_SIGNATURE_VALID : VERIFY_SIGNATURE_INVALID;
+    }
+
+private:
+    void append_next_pk_row() {
+        window_.append(nxt_row_number_++).payload = next_pk_row_;
+        next_pk_row_ = next_pk_row_->next;
+    }
+
+    static void free_pk_row(public_key_t *pk_row) {
+        for (int i = 0; i < P::t; i++)
+            std::free(pk_row->pks[i]);
+        std::free(pk_row->pks);
+        std::free(pk_row);
+    }
+
+    /// Same policy as mumhors_verifier_alloc_row_virtually with the default settings
+    bool allocate_row_virtually() {
+        if (nxt_row_number_ >= r_)
+            return false;
+
+        int removed_rows = 0;
+        for (int i = 0; i < window_.active_rows(); i++)
+            if (!window_.at(i).set_bits)
+                free_pk_row(window_.at(i).payload);
+        if (!(removed_rows = window_.remove_empty_rows())) {
+            int position = window_.position_of_fewest_set_bits();
+            free_pk_row(window_.at(position).payload);
+            window_.remove(position);
+            removed_rows = 1;
+        }
+
+        int possible_rows_to_add = static_cast<int>(std::min<long long>(removed_rows, r_ - nxt_row_number_));
+        for (int i = 0; i < possible_rows_to_add; i++)
+            append_next_pk_row();
+        return true;
+    }
+
+    long long r_;
+    long long nxt_row_number_ = 0;
+    public_key_t *next_pk_row_;
+    detail::fixed_window<P, public_key_t *> window_;
+};
+
+/// Parameter sets with a specialized signer and verifier. t = 1024, k = 25 is the 128-bit setting of the README,
+/// the others keep k * log2(t) within one Blake2b-256 output.
+using fixed_parameter_sets = std::tuple<
+    fixed_params<1024, 25, 256, 8>,
+    fixed_params<1024, 25, 256, 11>,
+    fixed_params<1024, 25, 256, 16>,
+    fixed_params<1024, 25, 256, 32>,
+    fixed_params<512, 28, 256, 11>,
+    fixed_params<2048, 23, 256, 11>,
+    fixed_params<4096, 21, 256, 11>
+>;
+
+namespace detail {
+template<typename Interface, typename Factory, typename... Sets>
+std::unique_ptr<Interface> dispatch(int t, int k, int l, int rt, std::tuple<Sets...> *, Factory factory) {
+    std::unique_ptr<Interface> instance;
+    (void) ((Sets::t == t && Sets::k == k && Sets::l == l && Sets::rt == rt
+                 ? (instance = factory.template operator()<Sets>(), true)
+                 : false) || ...);
+    return instance;
+}
+} // namespace detail
+
+/// Returns whether the fixed window implements the settings (those of a C signer/verifier left at its defaults)
+/// \param eviction_policy Eviction policy (EVICTION_*, see mumhors_signer_set_eviction)
+/// \param rt_min Smallest row limit (see mumhors_signer_set_row_limit)
+/// \param rt Row threshold
+/// \param run Signatures served by one extension (see mumhors_signer_set_extension_run)
+inline bool fixed_settings_supported(int eviction_policy, int rt_min, int rt, int run) {
+    return eviction_policy == EVICTION_FEWEST && rt_min == rt && run == 1;
+}
+
+/// Creates the specialized signer of the given parameters (rt must not exceed r, as in the C signer)
+/// \param eviction_policy Eviction policy of the C signer it stands for (EVICTION_*)
+/// \param eviction_param Parameter of the eviction policy
+/// \param rt_min Smallest row limit of the C signer (rt for a fixed limit)
+/// \param run Signatures served by one extension of the C signer
+/// \return The signer, or nullptr if the parameters are not in fixed_parameter_sets or the settings are not the
+/// defaults (see fixed_settings_supported; use the C signer instead)
+inline std::unique_ptr<signer_interface> make_fixed_signer(int t, int k, int l, int rt, const unsigned char *seed,
+                                                           int seed_len, long long r, int eviction_policy,
+                                                           int eviction_param, int rt_min, int run) {
+    (void) eviction_param;
+    if (rt > r || !fixed_settings_supported(eviction_policy, rt_min, rt, run))
+        return nullptr;
+    return detail::dispatch<signer_interface>(
+        t, k, l, rt, static_cast<fixed_parameter_sets *>(nullptr),
+        [&]<typename P>() -> std::unique_ptr<signer_interface> {
+            return std::make_unique<fixed_signer<P>>(seed, seed_len, r);
+        });
+}
+
+/// Creates the specialized verifier of the given parameters. The verifier takes the ownership of the matrix only
+/// when it is created.
+/// \param eviction_policy Eviction policy of the C verifier it stands for (EVICTION_*)
+/// \param eviction_param Parameter of the eviction policy
+/// \param rt_min Smallest row limit of the C verifier (rt for a fixed limit)
+/// \param run Signatures served by one extension of the C verifier
+/// \return The verifier, or nullptr if the parameters are not in fixed_parameter_sets or the settings are not the
+/// defaults (see fixed_settings_supported; use the C verifier instead)
+inline std::unique_ptr<verifier_interface> make_fixed_verifier(int t, int k, int l, int rt,
+                                                               public_key_matrix_t pk_matrix, long long r,
+                                                               int eviction_policy, int eviction_param, int rt_min,
+                                                               int run) {
+    (void) eviction_param;
+    if (rt > r || !fixed_settings_supported(eviction_policy, rt_min, rt, run))
+        return nullptr;
+    return detail::dispatch<verifier_interface>(
+        t, k, l, rt, static_cast<fixed_parameter_sets *>(nullptr),
+        [&]<typename P>() -> std::unique_ptr<verifier_interface> {
+            return std::make_unique<fixed_verifier<P>>(pk_matrix, r);
+        });
+}
+
+} // namespace mumhors
+
+#endif
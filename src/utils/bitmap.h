@@ -5,79 +5,226 @@
 #define BITMAP_NO_MORE_ROWS_TO_ALLOCATE 1
 #define BITMAP_EXTENSION_SUCCESS 0
 #define BITMAP_EXTENSION_FAILED 1
+#define BITMAP_RESTORE_SUCCESS 0
+#define BITMAP_RESTORE_FAILED 1
+#define BITMAP_INIT_SUCCESS 0
+#define BITMAP_INIT_FAILED 1
+
+#include <stddef.h>
+#include <stdint.h>
+#include "fenwick.h"
+#include "minheap.h"
+#include "eviction.h"
+#include "row_limit.h"
+
+/* Largest window: the bits of rt rows (the window indices and the Fenwick sums over the rows are ints) */
+#define BITMAP_MAX_WINDOW_BITS INT32_MAX
+
+/* Largest window of a snapshot: the rows bitmap_restore allocates */
+#define BITMAP_RESTORE_MAX_ROWS (1 << 20)
+
+/* Number of 64-bit words of a row with the given number of columns */
+#define BITMAP_WORDS(cols) (((cols) + 63) / 64)
+
+/* Alignment of the row buffers of the array engine and of the row chunks of the list engine (cache line) */
+#define BITMAP_BUFFER_ALIGNMENT 64
+
+/* Rounds a size up to a multiple of the alignment */
+#define BITMAP_ALIGN_UP(bytes, alignment) (((bytes) + (alignment) - 1) / (alignment) * (alignment))
+
+/* Row summary of the summary engine: the set bits of each block of BITMAP_SUMMARY_FANOUT words, of each block of
+ * BITMAP_SUMMARY_FANOUT blocks and so on up to the whole row, so a select or a clear takes one step per level */
+#define BITMAP_SUMMARY_FANOUT 8
+#define BITMAP_SUMMARY_MAX_LEVELS 12 /* Levels of 2^31 columns */
 
 #ifdef JOURNAL
 /// A group of journaling information which show the performance of the bitmap
 typedef struct bitmap_journaling {
-    int cnt_call_alloc_more_rows_call;    /* Number of calls to the row allocation procedure */
-    int cnt_call_cleanup_call;       /* Number of calls to the cleanup procedure */
-    int cnt_call_cleanup_rows_removed;      /* Total number of rows removed by cleanup */
-    int cnt_call_direct_remove_row;     /* Number of calls to direct row removal */
-    int cnt_cnt_unset_call;        /* Number of calls to the unset procedure */
-    int cnt_cnt_get_row_col_call;        /* Number of calls to the get row and column indices of the given bit index */
-    int cnt_discarded_bits;     /* Counting the number of discard bits */
-    int cnt_discarded_rows;        /* Total number of rows discarded */
+    long long cnt_call_alloc_more_rows_call;    /* Number of calls to the row allocation procedure */
+    long long cnt_call_cleanup_call;       /* Number of calls to the cleanup procedure */
+    long long cnt_call_cleanup_rows_removed;      /* Total number of rows removed by cleanup */
+    long long cnt_call_direct_remove_row;     /* Number of calls to direct row removal */
+    long long cnt_cnt_unset_call;        /* Number of calls to the unset procedure */
+    long long cnt_cnt_get_row_col_call;        /* Number of calls to the get row and column indices of the given bit index */
+    long long cnt_batch_call;        /* Number of calls to the batched select-and-clear procedure */
 
     double total_time_cleanup;
     double total_time_remove_row;
     double total_time_get_row_col;
     double total_time_unset_bits;
+    double total_time_batch;
 
 } bitmap_journaling_t;
 #endif
 
-/// Row data structure to represent each row with its meta parameters and data
+/// Row data structure to represent each row with its meta parameters and data. Column c of the row is bit c % 64
+/// of word c / 64, and rank[w] counts the set bits of the words before w, so finding the n-th set bit takes a
+/// binary search over the ranks and one select inside a word. The array and summary engines keep the row number and
+/// set bits in the dense arrays of their matrix (see bitmap_array_matrix_t) and only use the words and the ranks (the
+/// block counts and the non-empty masks in the summary engine) of the row.
 typedef struct row {
-    int number;             /* Row number */
-    int set_bits;           /* Number of set bits (1s) in the row */
-#ifdef BITMAP_LIST
-    unsigned char *data;    /* The pointer to the bytes of the row in list structure */
-    struct row *next;       /* Pointer to the next row in the list */
-#elif BITMAP_ARRAY
-    unsigned char data[BIT_VECTOR/8];    /* The pointer to the bytes of the row in array structure */
-#endif
+    long long number;       /* Row number (list engine) */
+    int set_bits;           /* Number of set bits (1s) in the row (list engine) */
+    int slot;               /* Id of the row in the eviction heap (list engine) */
+    uint64_t *data;         /* The words of the row (inside the row buffer of its slot in the array engines) */
+    int *rank;              /* Number of set bits before each word (block counts of each level in the summary engine) */
+    uint64_t *nonempty;     /* Words with set bits, one bit per word (summary engine) */
+    struct row *next;       /* Pointer to the next row in the list (list engine) */
 } row_t;
 
-/// Bitmap matrix containing the rows of the bitmap matrix
-typedef struct bitmap_row_matrix {
-#ifdef BITMAP_LIST
+/// Rows of the linked-list engine. The rows come from a pool of rt chunks (a row header, then its words and ranks)
+/// in one aligned allocation; the chunk of a row is its slot, so removing and allocating rows only moves slots.
+typedef struct bitmap_list_matrix {
     row_t *head; /* Pointer to the first row of the matrix */
     row_t *tail; /* Pointer to the last row of the matrix. Tail pointer is used for fast insertion. */
-#elif BITMAP_ARRAY
-    int size;                      /* Number of rows in the array */
-    int head;                      /* Index of the first row of the matrix */
-    int tail;                      /* Index of the last row of the matrix */
-    row_t rows[ROW_THRESHOLD];     /* Array of rows */
-#endif
-} bitmap_row_matrix_t;
+    row_t **window_rows; /* Active rows in window order (the positions of the Fenwick tree) */
+    int stride;  /* Bytes from one chunk to the next (a multiple of the cache line) */
+    unsigned char *pool; /* Chunks of the rows, addressed by slot */
+    int *free_slots; /* Slots (heap ids) of the removed rows, reused by the next allocations */
+    int free_count;  /* Number of free slots */
+} bitmap_list_matrix_t;
+
+/// Rows of the array engine: row buffers addressed by slot, and the window in dense arrays
+typedef struct bitmap_array_matrix {
+    int size;                /* Number of row buffers in the array (rt) */
+    int stride;              /* Bytes from one row buffer to the next (a multiple of the cache line) */
+    unsigned char *buffers;  /* Row buffers (the words of a row, then its ranks) in one aligned allocation */
+    row_t *rows;             /* Words and ranks of each slot (pointing into its row buffer) */
+    int *slots;              /* Slot of the row at each window position */
+    long long *numbers;      /* Row number at each window position */
+    int *set_bits;           /* Number of set bits (1s) at each window position */
+    int *free_slots;         /* Slots of the removed rows, reused by the next allocations */
+    int free_count;          /* Number of free slots */
+} bitmap_array_matrix_t;
+
+/// Rows of the summary engine: the array layout, with row buffers holding the words, the block counts and the
+/// non-empty masks, and the shape of the block counts (the same for every row)
+typedef struct bitmap_summary_matrix {
+    bitmap_array_matrix_t array;                  /* Rows and window (first, so the layouts of both engines match) */
+    int levels;                                   /* Levels of block counts (the last one is the whole row) */
+    int level_offset[BITMAP_SUMMARY_MAX_LEVELS];  /* First count of each level in the block counts of a row */
+    int level_size[BITMAP_SUMMARY_MAX_LEVELS];    /* Number of blocks of each level */
+    int counts;                                   /* Block counts of a row (all levels) */
+    int masks;                                    /* Non-empty masks of a row */
+} bitmap_summary_matrix_t;
+
+typedef struct bitmap_engine bitmap_engine_t;
 
 /// Bitmap structure
 typedef struct bitmap {
-    int r; /* Total number of rows */
-    int cB; /* Total number of columns in terms of Bytes */
-    int rt; /* Threshold on number of active rows */
-    int nxt_row_number; /* Row number of the next usable row */
+    const bitmap_engine_t *engine; /* Engine storing the rows */
+    long long r; /* Total number of rows */
+    int c; /* Total number of columns in terms of bits */
+    int cW; /* Total number of columns in terms of 64-bit words */
+    int rt; /* Threshold on number of active rows (the capacity of the window, the largest row limit) */
+    long long nxt_row_number; /* Row number of the next usable row */
     int active_rows; /* Number of active rows */
-    int set_bits; /* Number of set bits in the active rows */
+    long long set_bits; /* Number of set bits in the active rows */
     int window_size; /* Size of the window for the operations */
-    bitmap_row_matrix_t bitmap_matrix; /* The matrix of rows (linked list) containing the rows */
+    union {
+        bitmap_list_matrix_t list;
+        bitmap_array_matrix_t array;
+        bitmap_summary_matrix_t summary;
+    } bitmap_matrix; /* The matrix of rows, in the layout of the engine */
+    fenwick_t set_bits_index; /* Fenwick tree over the set bits of the active rows, in window order */
+    minheap_t eviction_heap; /* Active rows by set bits (row slots as ids), for eviction and empty row detection */
+    int eviction_policy; /* Rows evicted from a full window without empty rows (EVICTION_*) */
+    int eviction_param; /* Parameter of the eviction policy */
+    long long discarded_bits; /* Set bits of the evicted rows (private keys that will never be used) */
+    long long discarded_rows; /* Number of evicted rows */
+    row_limit_t row_limit; /* Number of rows the window may hold (rt unless it is adaptive) */
+    int headroom; /* Set bits beyond the window size that an extension tops the window up to */
 #ifdef JOURNAL
     bitmap_journaling_t bitmap_report; /* Report of the bitmap execution performance */
 #endif
 } bitmap_t;
 
+/// Operations of a bitmap engine (a layout of the rows). All engines keep the same window: the active rows in row
+/// number order, the Fenwick tree over their set bits and the eviction heap. So they select, clear and evict the
+/// same bits and can replace each other at runtime.
+struct bitmap_engine {
+    const char *name; /* Name of the engine */
+    int (*init)(bitmap_t *bm); /* Allocates the layout and the first rt rows (the hyperparameters are set), returns
+                                * BITMAP_INIT_FAILED with nothing allocated if an allocation fails */
+    void (*destroy)(bitmap_t *bm); /* Frees the rows and the layout */
+    int (*extend)(bitmap_t *bm); /* See bitmap_extend_matrix */
+    void (*select)(bitmap_t *bm, int target_index, long long *row_num,
+                   int *col_num); /* See bitmap_get_row_colum_with_index */
+    void (*unset)(bitmap_t *bm, int *indices, int num_index); /* See bitmap_unset_indices_in_window */
+    void (*select_and_clear)(bitmap_t *bm, const int *indices, const int *sorted_indices, int num_index,
+                             long long *row_nums, int *col_nums); /* See bitmap_select_and_clear */
+    void (*remove)(bitmap_t *bm, int position); /* See bitmap_remove_row */
+    size_t (*snapshot)(const bitmap_t *bm, unsigned char *buffer); /* Writes the active rows of a snapshot */
+    int (*restore)(bitmap_t *bm, const unsigned char *rows, size_t length, int active_rows,
+                   long long nxt_row_number); /* Replaces the rows of a new bitmap by the rows of a snapshot */
+#ifdef JOURNAL
+    void (*report)(const bitmap_t *bm); /* See bitmap_report */
+#endif
+};
+
+/* The engines. The rows are pooled chunks (header and bits) linked in a list in the first one, and buffers of one
+ * aligned allocation with their metadata in dense arrays in the second one. The third one keeps the rows of the
+ * second one with a summary of block counts instead of the ranks of the words, for rows of thousands of words. */
+extern const bitmap_engine_t bitmap_list_engine;
+extern const bitmap_engine_t bitmap_array_engine;
+extern const bitmap_engine_t bitmap_summary_engine;
+
+/* All engines, for benchmarks and command lines */
+#define BITMAP_NUM_ENGINES 3
+extern const bitmap_engine_t *const bitmap_engines[BITMAP_NUM_ENGINES];
+
+/* Engine used when none is given: -DBITMAP_ARRAY selects the array engine, -DBITMAP_SUMMARY the summary engine,
+ * otherwise the list engine */
+#ifdef BITMAP_ARRAY
+#define BITMAP_DEFAULT_ENGINE (&bitmap_array_engine)
+#elif defined(BITMAP_SUMMARY)
+#define BITMAP_DEFAULT_ENGINE (&bitmap_summary_engine)
+#else
+#define BITMAP_DEFAULT_ENGINE (&bitmap_list_engine)
+#endif
+
+/// Returns the engine with the given name
+/// \param name Name of the engine
+/// \return Pointer to the engine or NULL if there is no such engine
+const bitmap_engine_t *bitmap_engine_find(const char *name);
+
 /// Initializing the bitmap structure
 /// \param bm Pointer to the bitmap structure
+/// \param engine Engine storing the rows (NULL for BITMAP_DEFAULT_ENGINE)
 /// \param rows Number of rows
 /// \param cols Number of columns in terms of (bits)
 /// \param row_threshold Threshold on number of rows (maximum number of rows at a time)
 /// \param window_size Window size for operations
-void bitmap_init(bitmap_t *bm, int rows, int cols, int row_threshold, int window_size);
+/// \return BITMAP_INIT_SUCCESS or BITMAP_INIT_FAILED (the window is larger than BITMAP_MAX_WINDOW_BITS bits or an
+/// allocation failed, bm is left uninitialized)
+int bitmap_init(bitmap_t *bm, const bitmap_engine_t *engine, long long rows, int cols, int row_threshold,
+                 int window_size);
 
 /// Deleting the bitmap structure
 /// \param bm Pointer to the bitmap structure
 void bitmap_delete(bitmap_t *bm);
 
+/// Sets the eviction policy of the bitmap (EVICTION_FEWEST by default). The verifier must use the same policy.
+/// \param bm Pointer to the bitmap structure
+/// \param policy Policy id (EVICTION_*)
+/// \param param Parameter of the policy (see eviction.h)
+void bitmap_set_eviction(bitmap_t *bm, int policy, int param);
+
+/// Makes the row limit of the bitmap adaptive between min_rows and rt (see row_limit.h). It must be set before the
+/// first signature, with the same parameters as the verifier.
+/// \param bm Pointer to the bitmap structure
+/// \param min_rows Smallest limit (rt keeps the limit fixed)
+/// \param target Discard rate target, per mille
+/// \param epoch Rows entering the window between two adjustments
+void bitmap_set_row_limit(bitmap_t *bm, int min_rows, int target, int epoch);
+
+/// Sets the headroom of the extensions (0 by default): an extension tops the window up to window_size + headroom set
+/// bits (as far as the row limit leaves room for), so (headroom / k) more signatures of k indices need no extension.
+/// It must be set before the first signature, with the same headroom as the verifier.
+/// \param bm Pointer to the bitmap structure
+/// \param headroom Set bits beyond the window size
+void bitmap_set_headroom(bitmap_t *bm, int headroom);
+
 /// Extending the bitmap to hold more 1s
 /// \param bm Pointer to the bitmap structure
 /// \return BITMAP_EXTENSION_SUCCESS or BITMAP_EXTENSION_FAILED
@@ -88,7 +235,7 @@ int bitmap_extend_matrix(bitmap_t *bm);
 /// \param target_index Target index for which we want the row and column numbers
 /// \param row_num Pointer to variable which will store the row number
 /// \param col_num Pointer to variable which will store the column number
-void bitmap_get_row_colum_with_index(bitmap_t *bm, int target_index, int *row_num, int *col_num);
+void bitmap_get_row_colum_with_index(bitmap_t *bm, int target_index, long long *row_num, int *col_num);
 
 /// Unsetting the passed indices in the bitmap
 /// \param bm Pointer to the bitmap structure
@@ -96,6 +243,45 @@ void bitmap_get_row_colum_with_index(bitmap_t *bm, int target_index, int *row_nu
 /// \param num_index Number of passed indices
 void bitmap_unset_indices_in_window(bitmap_t *bm, int *indices, int num_index);
 
+/// Finds the row and column numbers of a set of indices and unsets them, in one walk over the rows and words
+/// \param bm Pointer to the bitmap structure
+/// \param indices Array of distinct indices (message order)
+/// \param sorted_indices The same indices in descending order
+/// \param num_index Number of passed indices
+/// \param row_nums Array which will store the row number of each index (message order)
+/// \param col_nums Array which will store the column number of each index (message order)
+void bitmap_select_and_clear(bitmap_t *bm, const int *indices, const int *sorted_indices, int num_index,
+                             long long *row_nums, int *col_nums);
+
+/// Removes an active row from the window (its set bits are discarded)
+/// \param bm Pointer to the bitmap structure
+/// \param position Window position of the row
+void bitmap_remove_row(bitmap_t *bm, int position);
+
+/// Returns the largest size of the snapshot of the bitmap
+/// \param bm Pointer to the bitmap structure
+/// \return Size in bytes
+size_t bitmap_snapshot_size_bound(const bitmap_t *bm);
+
+/// Writes a snapshot of the bitmap: the hyperparameters, the eviction policy, the row limit, the headroom, the next
+/// row number and the number and bits of each active row. Every row is stored in the smallest of raw bytes, a list of
+/// its set or of its unset columns, or its runs, so nearly-full and nearly-empty rows take a few bytes. The snapshot
+/// does not depend on the engine.
+/// \param bm Pointer to the bitmap structure
+/// \param buffer Output buffer (at least bitmap_snapshot_size_bound bytes)
+/// \return Size of the snapshot in bytes
+size_t bitmap_snapshot(const bitmap_t *bm, unsigned char *buffer);
+
+/// Initializes a bitmap from a snapshot, with any engine. The ranks, counters, Fenwick tree and eviction heap are
+/// rebuilt from the rows in one pass; the bitmap then selects, clears and evicts like the one of the snapshot.
+/// \param bm Pointer to the bitmap structure (not initialized)
+/// \param engine Engine storing the rows (NULL for BITMAP_DEFAULT_ENGINE)
+/// \param snapshot Snapshot written by bitmap_snapshot
+/// \param length Size of the snapshot in bytes
+/// \return BITMAP_RESTORE_SUCCESS or BITMAP_RESTORE_FAILED (the snapshot is malformed, its window is larger than
+/// BITMAP_RESTORE_MAX_ROWS rows or BITMAP_MAX_WINDOW_BITS bits, or it cannot be allocated; bm is left uninitialized)
+int bitmap_restore(bitmap_t *bm, const bitmap_engine_t *engine, const unsigned char *snapshot, size_t length);
+
 #ifdef JOURNAL
 /// Presents a report of the bitmap performance
 /// \param bm Pointer to the bitmap structure
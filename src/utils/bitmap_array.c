@@ -0,0 +1,23 @@
+#include <stdint.h>
+#include "bitmap.h"
+
+/* Array engine: the rows live in the buffers of one aligned allocation (the words, then their ranks), their metadata
+ * in dense arrays indexed by window position */
+#define ARRAY_MATRIX(bm) (&(bm)->bitmap_matrix.array)
+
+#include "bitmap_array_layout.h"
+
+
+static size_t bitmap_row_buffer_bytes(const bitmap_t *bm) {
+    return (sizeof(uint64_t) + sizeof(int)) * bm->cW;
+}
+
+
+static void bitmap_row_attach(const bitmap_t *bm, row_t *row, unsigned char *buffer) {
+    row->data = (uint64_t *) buffer;
+    row->rank = (int *) (buffer + sizeof(uint64_t) * bm->cW);
+}
+
+
+const bitmap_engine_t bitmap_array_engine = BITMAP_ENGINE_OPS("array", bitmap_array_layout_init,
+                                                              bitmap_array_layout_destroy);
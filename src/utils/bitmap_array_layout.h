@@ -0,0 +1,168 @@
+#ifndef MUMHORS_BITMAP_ARRAY_LAYOUT_H
+#define MUMHORS_BITMAP_ARRAY_LAYOUT_H
+
+/* Array layout of the array and summary engines: the rows live in the buffers of one aligned allocation, their
+ * metadata in dense arrays indexed by window position. The including engine defines before including this file:
+ *     ARRAY_MATRIX(bm)                  Pointer to its bitmap_array_matrix_t
+ * and the row buffer functions declared below. */
+
+#include <string.h>
+#include <stdlib.h>
+#include "bitmap.h"
+
+#define ENGINE_MATRIX(bm) ARRAY_MATRIX(bm)
+#define ROW_NUMBER(bm, row, position) (ARRAY_MATRIX(bm)->numbers[position])
+#define ROW_SET_BITS(bm, row, position) (ARRAY_MATRIX(bm)->set_bits[position])
+#define ROW_SLOT(bm, row, position) (ARRAY_MATRIX(bm)->slots[position])
+
+
+/// Returns the size of a row buffer (defined by the engine)
+/// \param bm Pointer to the bitmap structure
+/// \return Size in bytes
+static size_t bitmap_row_buffer_bytes(const bitmap_t *bm);
+
+/// Points the words and the word index of a row into its row buffer (defined by the engine)
+/// \param bm Pointer to the bitmap structure
+/// \param row Pointer to the row
+/// \param buffer Row buffer (aligned to BITMAP_BUFFER_ALIGNMENT)
+static void bitmap_row_attach(const bitmap_t *bm, row_t *row, unsigned char *buffer);
+
+
+/// Returns the active row at a window position
+/// \param bm Pointer to the bitmap structure
+/// \param position Window position
+/// \return Pointer to the row
+static row_t *bitmap_row_at(bitmap_t *bm, int position) {
+    return &ARRAY_MATRIX(bm)->rows[ARRAY_MATRIX(bm)->slots[position]];
+}
+
+#include "bitmap_window.h"
+
+
+static void bitmap_index_rebuild(bitmap_t *bm) {
+    /* The set bits are already dense and in window order */
+    fenwick_build(&bm->set_bits_index, ARRAY_MATRIX(bm)->set_bits, bm->active_rows);
+}
+
+
+static void bitmap_engine_add_row(bitmap_t *bm) {
+    /* Reuse the buffer of a removed row */
+    bitmap_array_matrix_t *matrix = ARRAY_MATRIX(bm);
+    int position = bm->set_bits_index.size;
+    matrix->slots[position] = bitmap_acquire_slot(bm);
+    row_t *new_row = &matrix->rows[matrix->slots[position]];
+
+    /* Initializing the vector to all 1s */
+    bitmap_fill_row(bm, new_row, position, bm->nxt_row_number);
+    bitmap_index_append(bm, new_row, position);
+}
+
+
+static int bitmap_row_cleanup(bitmap_t *bm) {
+#ifdef JOURNAL
+    bm->bitmap_report.cnt_call_cleanup_call++;
+#endif
+    /* The eviction heap counts the empty rows, so there is nothing to scan for when there is none */
+    if (!bm->eviction_heap.empty)
+        return 0;
+#ifdef JOURNAL
+    gettimeofday(&start_time, NULL);
+#endif
+    /* Compact the window over the empty rows in one pass, their buffers become free */
+    bitmap_array_matrix_t *matrix = ARRAY_MATRIX(bm);
+    int kept_rows = 0;
+    for (int position = 0; position < bm->active_rows; position++) {
+        if (matrix->set_bits[position]) {
+            matrix->slots[kept_rows] = matrix->slots[position];
+            matrix->numbers[kept_rows] = matrix->numbers[position];
+            matrix->set_bits[kept_rows] = matrix->set_bits[position];
+            kept_rows++;
+        } else
+            bitmap_release_slot(bm, matrix->slots[position]);
+    }
+    int cleaned_rows = bm->active_rows - kept_rows;
+    bm->active_rows = kept_rows;
+#ifdef JOURNAL
+    bm->bitmap_report.cnt_call_cleanup_rows_removed += cleaned_rows;
+    gettimeofday(&end_time, NULL);
+    bm->bitmap_report.total_time_cleanup += (end_time.tv_sec - start_time.tv_sec) + (
+        end_time.tv_usec - start_time.tv_usec) / 1.0e6;
+#endif
+    return cleaned_rows;
+}
+
+
+/* Only the slots and the metadata of the rows after the removed one move (4-byte entries); the buffer of the row is
+ * kept for the next allocation. */
+static void bitmap_engine_remove_row(bitmap_t *bm, int position) {
+    bitmap_array_matrix_t *matrix = ARRAY_MATRIX(bm);
+    bm->discarded_bits += matrix->set_bits[position];
+    bm->discarded_rows++;
+#ifdef JOURNAL
+    gettimeofday(&start_time, NULL);
+#endif
+
+    /* Remove the row */
+    bm->set_bits -= matrix->set_bits[position];
+    bm->active_rows--;
+    bitmap_release_slot(bm, matrix->slots[position]);
+
+    /* Close the gap in the window */
+    int moved_rows = bm->active_rows - position;
+    memmove(matrix->slots + position, matrix->slots + position + 1, sizeof(int) * moved_rows);
+    memmove(matrix->numbers + position, matrix->numbers + position + 1, sizeof(long long) * moved_rows);
+    memmove(matrix->set_bits + position, matrix->set_bits + position + 1, sizeof(int) * moved_rows);
+
+#ifdef JOURNAL
+    gettimeofday(&end_time, NULL);
+    bm->bitmap_report.total_time_remove_row += (end_time.tv_sec - start_time.tv_sec) + (
+        end_time.tv_usec - start_time.tv_usec) / 1.0e6;
+#endif
+}
+
+
+/// Frees the row buffers and the window arrays
+/// \param bm Pointer to the bitmap structure
+static void bitmap_array_layout_destroy(bitmap_t *bm) {
+    bitmap_array_matrix_t *matrix = ARRAY_MATRIX(bm);
+    free(matrix->buffers);
+    free(matrix->rows);
+    free(matrix->slots);
+    free(matrix->numbers);
+    free(matrix->set_bits);
+    free(matrix->free_slots);
+}
+
+
+/// Allocates the row buffers, the window arrays and the first rt rows
+/// \param bm Pointer to the bitmap structure
+/// \return BITMAP_INIT_SUCCESS or BITMAP_INIT_FAILED (an allocation failed, nothing stays allocated)
+static int bitmap_array_layout_init(bitmap_t *bm) {
+    bitmap_array_matrix_t *matrix = ARRAY_MATRIX(bm);
+    matrix->size = bm->rt;
+
+    /* All row buffers come from one allocation, each one starting on a cache line */
+    matrix->stride = BITMAP_ALIGN_UP(bitmap_row_buffer_bytes(bm), BITMAP_BUFFER_ALIGNMENT);
+    matrix->buffers = aligned_alloc(BITMAP_BUFFER_ALIGNMENT, (size_t) matrix->stride * matrix->size);
+    matrix->rows = malloc(sizeof(row_t) * matrix->size);
+    matrix->slots = malloc(sizeof(int) * matrix->size);
+    matrix->numbers = malloc(sizeof(long long) * matrix->size);
+    matrix->set_bits = malloc(sizeof(int) * matrix->size);
+    matrix->free_slots = malloc(sizeof(int) * matrix->size);
+    if (!matrix->buffers || !matrix->rows || !matrix->slots || !matrix->numbers || !matrix->set_bits ||
+        !matrix->free_slots) {
+        bitmap_array_layout_destroy(bm);
+        return BITMAP_INIT_FAILED;
+    }
+    for (int slot = 0; slot < matrix->size; slot++)
+        bitmap_row_attach(bm, &matrix->rows[slot], matrix->buffers + (size_t) slot * matrix->stride);
+
+    /* The free slots are popped from the end: the first rows get the buffers in order */
+    for (matrix->free_count = 0; matrix->free_count < matrix->size; matrix->free_count++)
+        matrix->free_slots[matrix->free_count] = matrix->size - 1 - matrix->free_count;
+
+    bitmap_window_init_rows(bm);
+    return BITMAP_INIT_SUCCESS;
+}
+
+#endif
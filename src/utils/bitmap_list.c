@@ -0,0 +1,187 @@
+#include <stdlib.h>
+#include "bitmap.h"
+
+/* Linked-list engine: every row carries its metadata and lives in a chunk of the row pool */
+#define ENGINE_MATRIX(bm) (&(bm)->bitmap_matrix.list)
+#define ROW_NUMBER(bm, row, position) ((row)->number)
+#define ROW_SET_BITS(bm, row, position) ((row)->set_bits)
+#define ROW_SLOT(bm, row, position) ((row)->slot)
+
+
+/// Returns the active row at a window position
+/// \param bm Pointer to the bitmap structure
+/// \param position Window position
+/// \return Pointer to the row
+static row_t *bitmap_row_at(bitmap_t *bm, int position) {
+    return bm->bitmap_matrix.list.window_rows[position];
+}
+
+#include "bitmap_window.h"
+
+
+/// Returns the row in the chunk of a slot
+/// \param matrix Pointer to the list matrix
+/// \param slot Slot of the row
+/// \return Pointer to the row
+static row_t *bitmap_pool_row(const bitmap_list_matrix_t *matrix, int slot) {
+    return (row_t *) (matrix->pool + (size_t) slot * matrix->stride);
+}
+
+
+static void bitmap_index_rebuild(bitmap_t *bm) {
+    bitmap_list_matrix_t *matrix = &bm->bitmap_matrix.list;
+    int counts[bm->rt];
+    int position = 0;
+    for (row_t *row = matrix->head; row; row = row->next) {
+        matrix->window_rows[position] = row;
+        counts[position++] = row->set_bits;
+    }
+    fenwick_build(&bm->set_bits_index, counts, bm->active_rows);
+}
+
+
+static void bitmap_engine_add_row(bitmap_t *bm) {
+    bitmap_list_matrix_t *matrix = &bm->bitmap_matrix.list;
+    int position = bm->set_bits_index.size;
+    /* Reuse the chunk of a removed row */
+    row_t *new_row = bitmap_pool_row(matrix, bitmap_acquire_slot(bm));
+    new_row->next = NULL;
+
+    /* Initializing the vector to all 1s */
+    bitmap_fill_row(bm, new_row, position, bm->nxt_row_number);
+
+    /* Add the row to the matrix */
+    if (!matrix->head)
+        matrix->head = new_row;
+    else
+        matrix->tail->next = new_row;
+    matrix->tail = new_row;
+    matrix->window_rows[position] = new_row;
+    bitmap_index_append(bm, new_row, position);
+}
+
+
+static int bitmap_row_cleanup(bitmap_t *bm) {
+#ifdef JOURNAL
+    bm->bitmap_report.cnt_call_cleanup_call++;
+#endif
+    /* The eviction heap counts the empty rows, so there is nothing to scan for when there is none */
+    if (!bm->eviction_heap.empty)
+        return 0;
+#ifdef JOURNAL
+    gettimeofday(&start_time, NULL);
+#endif
+    bitmap_list_matrix_t *matrix = &bm->bitmap_matrix.list;
+    int cleaned_rows = 0;
+
+    /* Relink the window over the empty rows in one pass */
+    row_t *previous = NULL;
+    for (int position = 0; position < bm->active_rows; position++) {
+        row_t *row = matrix->window_rows[position];
+        if (row->set_bits) {
+            if (previous)
+                previous->next = row;
+            else
+                matrix->head = row;
+            previous = row;
+        } else {
+            /* The chunk of the row goes back to the pool */
+            bitmap_release_slot(bm, row->slot);
+            cleaned_rows++;
+        }
+    }
+    if (previous)
+        previous->next = NULL;
+    else
+        matrix->head = NULL;
+    matrix->tail = previous;
+    bm->active_rows -= cleaned_rows;
+#ifdef JOURNAL
+    bm->bitmap_report.cnt_call_cleanup_rows_removed += cleaned_rows;
+    gettimeofday(&end_time, NULL);
+    bm->bitmap_report.total_time_cleanup += (end_time.tv_sec - start_time.tv_sec) + (
+        end_time.tv_usec - start_time.tv_usec) / 1.0e6;
+#endif
+    return cleaned_rows;
+}
+
+
+static void bitmap_engine_remove_row(bitmap_t *bm, int position) {
+    bitmap_list_matrix_t *matrix = &bm->bitmap_matrix.list;
+    row_t *row = matrix->window_rows[position];
+    bm->discarded_bits += row->set_bits;
+    bm->discarded_rows++;
+#ifdef JOURNAL
+    gettimeofday(&start_time, NULL);
+#endif
+
+    /* The previous row is the one before it in the window */
+    if (row == matrix->head)
+        matrix->head = matrix->head->next;
+    else {
+        row_t *previous = matrix->window_rows[position - 1];
+        previous->next = row->next;
+        /* Updating the tail pointer */
+        if (row == matrix->tail)
+            matrix->tail = previous;
+    }
+
+    /* Updating the hyperparameters */
+    bm->active_rows--;
+    bm->set_bits -= row->set_bits;
+    bitmap_release_slot(bm, row->slot);
+
+#ifdef JOURNAL
+    gettimeofday(&end_time, NULL);
+    bm->bitmap_report.total_time_remove_row += (end_time.tv_sec - start_time.tv_sec) + (
+        end_time.tv_usec - start_time.tv_usec) / 1.0e6;
+#endif
+}
+
+
+/// Frees the row pool and the list
+/// \param bm Pointer to the bitmap structure
+static void bitmap_list_destroy(bitmap_t *bm) {
+    free(bm->bitmap_matrix.list.pool);
+    free(bm->bitmap_matrix.list.window_rows);
+    free(bm->bitmap_matrix.list.free_slots);
+}
+
+
+/// Allocates the row pool, the list and its first rt rows
+/// \param bm Pointer to the bitmap structure
+/// \return BITMAP_INIT_SUCCESS or BITMAP_INIT_FAILED (an allocation failed, nothing stays allocated)
+static int bitmap_list_init(bitmap_t *bm) {
+    bitmap_list_matrix_t *matrix = &bm->bitmap_matrix.list;
+    matrix->head = NULL;
+    matrix->tail = NULL;
+    matrix->window_rows = malloc(sizeof(row_t *) * bm->rt);
+
+    /* A chunk holds the row header on its first cache line, then the words and ranks of the row (so the words start
+     * on a cache line too) */
+    int header_bytes = BITMAP_ALIGN_UP(sizeof(row_t), BITMAP_BUFFER_ALIGNMENT);
+    matrix->stride = BITMAP_ALIGN_UP(header_bytes + (sizeof(uint64_t) + sizeof(int)) * bm->cW,
+                                     BITMAP_BUFFER_ALIGNMENT);
+    matrix->pool = aligned_alloc(BITMAP_BUFFER_ALIGNMENT, (size_t) matrix->stride * bm->rt);
+    matrix->free_slots = malloc(sizeof(int) * bm->rt);
+    if (!matrix->window_rows || !matrix->pool || !matrix->free_slots) {
+        bitmap_list_destroy(bm);
+        return BITMAP_INIT_FAILED;
+    }
+    for (int slot = 0; slot < bm->rt; slot++) {
+        row_t *row = bitmap_pool_row(matrix, slot);
+        row->slot = slot;
+        row->data = (uint64_t *) ((unsigned char *) row + header_bytes);
+        row->rank = (int *) (row->data + bm->cW);
+    }
+
+    /* The free slots are popped from the end: the first rows get the chunks in order */
+    for (matrix->free_count = 0; matrix->free_count < bm->rt; matrix->free_count++)
+        matrix->free_slots[matrix->free_count] = bm->rt - 1 - matrix->free_count;
+
+    bitmap_window_init_rows(bm);
+    return BITMAP_INIT_SUCCESS;
+}
+
+
+const bitmap_engine_t bitmap_list_engine = BITMAP_ENGINE_OPS("list", bitmap_list_init, bitmap_list_destroy);
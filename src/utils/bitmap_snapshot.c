@@ -0,0 +1,277 @@
+#include <string.h>
+#include "bitmap_snapshot.h"
+#include "mumhors_math.h"
+
+/* Number of varints of the header */
+#define BITMAP_SNAPSHOT_HEADER_FIELDS 18
+
+/* Whether each field of the header is 64-bit (the row counts, the set bits and the discard counters), the others
+ * are int */
+static const unsigned char bitmap_snapshot_wide_fields[BITMAP_SNAPSHOT_HEADER_FIELDS] = {
+    1, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1, 1
+};
+
+
+int bitmap_snapshot_put_varint(unsigned char *out, uint64_t value) {
+    int written = 0;
+    while (value >= 0x80) {
+        out[written++] = (unsigned char) (value | 0x80);
+        value >>= 7;
+    }
+    out[written++] = (unsigned char) value;
+    return written;
+}
+
+int bitmap_snapshot_get_varint(const unsigned char *in, size_t length, uint64_t *value) {
+    *value = 0;
+    for (int read = 0; read < BITMAP_SNAPSHOT_VARINT_MAX && (size_t) read < length; read++) {
+        *value |= (uint64_t) (in[read] & 0x7f) << (7 * read);
+        if (!(in[read] & 0x80))
+            return read + 1;
+    }
+    return 0;
+}
+
+
+size_t bitmap_snapshot_header_bound(void) {
+    return sizeof(BITMAP_SNAPSHOT_MAGIC) - 1 + 1 + BITMAP_SNAPSHOT_HEADER_FIELDS * BITMAP_SNAPSHOT_VARINT_MAX;
+}
+
+size_t bitmap_snapshot_write_header(const bitmap_snapshot_header_t *header, unsigned char *out) {
+    size_t written = sizeof(BITMAP_SNAPSHOT_MAGIC) - 1;
+    memcpy(out, BITMAP_SNAPSHOT_MAGIC, written);
+    out[written++] = BITMAP_SNAPSHOT_VERSION;
+    const long long fields[] = {
+        header->r, header->c, header->rt, header->window_size, header->nxt_row_number, header->active_rows,
+        header->set_bits, header->eviction_policy, header->eviction_param, header->row_limit_min, header->row_limit,
+        header->row_limit_target, header->row_limit_epoch, header->row_limit_epoch_rows,
+        header->row_limit_epoch_discarded, header->headroom, header->discarded_bits, header->discarded_rows
+    };
+    for (int i = 0; i < BITMAP_SNAPSHOT_HEADER_FIELDS; i++)
+        written += bitmap_snapshot_put_varint(out + written, (uint64_t) fields[i]);
+    return written;
+}
+
+size_t bitmap_snapshot_read_header(bitmap_snapshot_header_t *header, const unsigned char *in, size_t length) {
+    size_t read = sizeof(BITMAP_SNAPSHOT_MAGIC) - 1;
+    if (length < read + 1 || memcmp(in, BITMAP_SNAPSHOT_MAGIC, read) || in[read] != BITMAP_SNAPSHOT_VERSION)
+        return 0;
+    read++;
+    long long fields[BITMAP_SNAPSHOT_HEADER_FIELDS];
+    for (int i = 0; i < BITMAP_SNAPSHOT_HEADER_FIELDS; i++) {
+        uint64_t value;
+        int field_bytes = bitmap_snapshot_get_varint(in + read, length - read, &value);
+        if (!field_bytes || value > (bitmap_snapshot_wide_fields[i] ? INT64_MAX : INT32_MAX))
+            return 0;
+        fields[i] = (long long) value;
+        read += field_bytes;
+    }
+    header->r = fields[0];
+    header->c = (int) fields[1];
+    header->rt = (int) fields[2];
+    header->window_size = (int) fields[3];
+    header->nxt_row_number = fields[4];
+    header->active_rows = (int) fields[5];
+    header->set_bits = fields[6];
+    header->eviction_policy = (int) fields[7];
+    header->eviction_param = (int) fields[8];
+    header->row_limit_min = (int) fields[9];
+    header->row_limit = (int) fields[10];
+    header->row_limit_target = (int) fields[11];
+    header->row_limit_epoch = (int) fields[12];
+    header->row_limit_epoch_rows = (int) fields[13];
+    header->row_limit_epoch_discarded = fields[14];
+    header->headroom = (int) fields[15];
+    header->discarded_bits = fields[16];
+    header->discarded_rows = fields[17];
+    return read;
+}
+
+
+/// Returns the first column at or after a column whose bit differs from a value
+/// \param data Words of the row (the columns past the end are unset)
+/// \param cols Number of columns
+/// \param col First column to look at
+/// \param value Bit value (0 or 1)
+/// \return Column or cols if there is none
+static int bitmap_snapshot_next_change(const uint64_t *data, int cols, int col, int value) {
+    for (int w = col / 64; w < (cols + 63) / 64; w++) {
+        uint64_t differ = value ? ~data[w] : data[w];
+        if (w == col / 64)
+            differ &= ~0ULL << (col % 64);
+        if (differ)
+            return min(w * 64 + word_select(differ, 0), cols);
+    }
+    return cols;
+}
+
+/// Sets the columns of a range
+/// \param data Words of the row
+/// \param col First column of the range
+/// \param end Column after the range
+static void bitmap_snapshot_set_range(uint64_t *data, int col, int end) {
+    while (col < end) {
+        int bits = min(64 - col % 64, end - col);
+        data[col / 64] |= (bits == 64 ? ~0ULL : (1ULL << bits) - 1) << (col % 64);
+        col += bits;
+    }
+}
+
+/// Encodes the columns holding a bit value as their count and the gaps between them
+/// \param data Words of the row
+/// \param cols Number of columns
+/// \param value Bit value of the listed columns
+/// \param count Number of columns holding the value
+/// \param out Output buffer
+/// \param limit Size above which the encoding is abandoned
+/// \return Number of written bytes or 0 if the encoding exceeds the limit
+static size_t bitmap_snapshot_encode_positions(const uint64_t *data, int cols, int value, int count,
+                                               unsigned char *out, size_t limit) {
+    size_t written = bitmap_snapshot_put_varint(out, count);
+    int previous = -1;
+    for (int i = 0; i < count; i++) {
+        if (written + BITMAP_SNAPSHOT_VARINT_MAX > limit)
+            return 0;
+        int col = bitmap_snapshot_next_change(data, cols, previous + 1, !value);
+        written += bitmap_snapshot_put_varint(out + written, col - previous - 1);
+        previous = col;
+    }
+    return written <= limit ? written : 0;
+}
+
+/// Encodes a row as the lengths of its runs, starting with a run of 1s
+/// \param data Words of the row
+/// \param cols Number of columns
+/// \param out Output buffer
+/// \param limit Size above which the encoding is abandoned
+/// \return Number of written bytes or 0 if the encoding exceeds the limit
+static size_t bitmap_snapshot_encode_runs(const uint64_t *data, int cols, unsigned char *out, size_t limit) {
+    /* The number of runs goes first, so the lengths are staged until it is known */
+    unsigned char lengths[limit + BITMAP_SNAPSHOT_VARINT_MAX];
+    size_t written = 0;
+    int runs = 0, value = 1;
+    for (int col = 0; col < cols; value = !value, runs++) {
+        if (written + BITMAP_SNAPSHOT_VARINT_MAX > limit)
+            return 0;
+        int end = bitmap_snapshot_next_change(data, cols, col, value);
+        written += bitmap_snapshot_put_varint(lengths + written, end - col);
+        col = end;
+    }
+    size_t header = bitmap_snapshot_put_varint(out, runs);
+    if (header + written > limit)
+        return 0;
+    memcpy(out + header, lengths, written);
+    return header + written;
+}
+
+
+size_t bitmap_snapshot_row_bound(int cols) {
+    return 1 + cols / 8;
+}
+
+size_t bitmap_snapshot_encode_row(const uint64_t *data, int cols, unsigned char *out) {
+    /* A list or runs encoding is kept only if it is smaller than the raw bytes. Every listed column and every run
+     * takes at least one byte, so the encodings that cannot win are not tried. */
+    int words = (cols + 63) / 64;
+    size_t best = cols / 8;
+    int best_encoding = BITMAP_ROW_RAW;
+    unsigned char candidate[best + BITMAP_SNAPSHOT_VARINT_MAX];
+    int set_count = 0, changes = 0;
+    uint64_t previous_bit = 1; /* The runs start with 1s */
+    for (int w = 0; w < words; w++) {
+        uint64_t change = data[w] ^ (data[w] << 1 | previous_bit);
+        if (w == words - 1 && cols % 64)
+            change &= (1ULL << (cols % 64)) - 1;
+        set_count += word_popcount(data[w]);
+        changes += word_popcount(change);
+        previous_bit = data[w] >> 63;
+    }
+
+    const int encodings[] = {BITMAP_ROW_SET, BITMAP_ROW_CLEAR, BITMAP_ROW_RUNS};
+    const int least_sizes[] = {1 + set_count, 1 + cols - set_count, 2 + changes};
+    for (int i = 0; i < 3; i++) {
+        if ((size_t) least_sizes[i] >= best)
+            continue;
+        size_t size;
+        if (encodings[i] == BITMAP_ROW_SET)
+            size = bitmap_snapshot_encode_positions(data, cols, 1, set_count, candidate, best - 1);
+        else if (encodings[i] == BITMAP_ROW_CLEAR)
+            size = bitmap_snapshot_encode_positions(data, cols, 0, cols - set_count, candidate, best - 1);
+        else
+            size = bitmap_snapshot_encode_runs(data, cols, candidate, best - 1);
+        if (size) {
+            best = size;
+            best_encoding = encodings[i];
+            memcpy(out + 1, candidate, size);
+        }
+    }
+
+    out[0] = (unsigned char) best_encoding;
+    if (best_encoding == BITMAP_ROW_RAW) {
+        for (int j = 0; j < cols / 8; j++)
+            out[1 + j] = (unsigned char) (data[j / 8] >> (8 * (j % 8)));
+    }
+    return 1 + best;
+}
+
+
+size_t bitmap_snapshot_decode_row(const unsigned char *in, size_t length, int cols, uint64_t *data) {
+    int words = (cols + 63) / 64;
+    if (!length)
+        return 0;
+    int encoding = in[0];
+    size_t read = 1;
+    memset(data, 0, sizeof(uint64_t) * words);
+
+    if (encoding == BITMAP_ROW_RAW) {
+        if (length < read + cols / 8)
+            return 0;
+        for (int j = 0; j < cols / 8; j++)
+            data[j / 8] |= (uint64_t) in[read + j] << (8 * (j % 8));
+        return read + cols / 8;
+    }
+
+    uint64_t count;
+    int field_bytes = bitmap_snapshot_get_varint(in + read, length - read, &count);
+    if (!field_bytes || count > (uint64_t) cols)
+        return 0;
+    read += field_bytes;
+
+    if (encoding == BITMAP_ROW_SET || encoding == BITMAP_ROW_CLEAR) {
+        /* The unset columns are cleared from a full row */
+        int value = encoding == BITMAP_ROW_SET;
+        if (!value) {
+            for (int w = 0; w < words; w++)
+                data[w] = ~0ULL;
+            if (cols % 64)
+                data[words - 1] = (1ULL << (cols % 64)) - 1;
+        }
+        long col = -1;
+        for (uint64_t i = 0; i < count; i++) {
+            uint64_t gap;
+            field_bytes = bitmap_snapshot_get_varint(in + read, length - read, &gap);
+            if (!field_bytes || gap >= (uint64_t) cols || (col += (long) gap + 1) >= cols)
+                return 0;
+            read += field_bytes;
+            data[col / 64] ^= 1ULL << (col % 64);
+        }
+        return read;
+    }
+
+    if (encoding == BITMAP_ROW_RUNS) {
+        long col = 0;
+        for (uint64_t i = 0; i < count; i++) {
+            uint64_t run;
+            field_bytes = bitmap_snapshot_get_varint(in + read, length - read, &run);
+            if (!field_bytes || run > (uint64_t) (cols - col))
+                return 0;
+            read += field_bytes;
+            /* The runs alternate from a run of 1s */
+            if (!(i % 2))
+                bitmap_snapshot_set_range(data, (int) col, (int) (col + run));
+            col += run;
+        }
+        return col == cols ? read : 0;
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+#ifndef MUMHORS_BITMAP_SNAPSHOT_H
+#define MUMHORS_BITMAP_SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Snapshot format (see bitmap_snapshot and bitmap_restore). All integers are LEB128 varints.
+ *     magic "MHBS", version byte
+ *     r, c, rt, window_size, nxt_row_number, active_rows, set_bits, eviction_policy, eviction_param,
+ *     row limit (min, limit, target, epoch, epoch_rows, epoch_discarded), headroom, discarded_bits, discarded_rows
+ *     for each active row in window order: row number (as the gap to the previous one), encoding byte, payload
+ * The payload of a row is the smallest of its encodings below. */
+#define BITMAP_SNAPSHOT_MAGIC "MHBS"
+#define BITMAP_SNAPSHOT_VERSION 6
+
+#define BITMAP_SNAPSHOT_VARINT_MAX 10 /* Bytes of the largest 64-bit varint */
+
+#define BITMAP_ROW_RAW 0    /* The c / 8 bytes of the row, bit i of byte j is column 8j + i */
+#define BITMAP_ROW_SET 1    /* Number of set columns, then the gap before each one (nearly-empty rows) */
+#define BITMAP_ROW_CLEAR 2  /* Number of unset columns, then the gap before each one (nearly-full rows) */
+#define BITMAP_ROW_RUNS 3   /* Number of runs, then their lengths alternating from a (possibly empty) run of 1s */
+
+/// Header of a snapshot: the hyperparameters and the counters of the bitmap
+typedef struct bitmap_snapshot_header {
+    long long r;
+    int c;
+    int rt;
+    int window_size;
+    long long nxt_row_number;
+    int active_rows;
+    long long set_bits;
+    int eviction_policy;
+    int eviction_param;
+    int row_limit_min;
+    int row_limit;
+    int row_limit_target;
+    int row_limit_epoch;
+    int row_limit_epoch_rows;
+    long long row_limit_epoch_discarded;
+    int headroom;
+    long long discarded_bits;
+    long long discarded_rows;
+} bitmap_snapshot_header_t;
+
+/// Writes a varint
+/// \param out Output buffer (at least BITMAP_SNAPSHOT_VARINT_MAX bytes)
+/// \param value Value
+/// \return Number of written bytes
+int bitmap_snapshot_put_varint(unsigned char *out, uint64_t value);
+
+/// Reads a varint
+/// \param in Input buffer
+/// \param length Number of bytes left in the input
+/// \param value Pointer to variable which will store the value
+/// \return Number of read bytes or 0 if the input ends or the varint is too long
+int bitmap_snapshot_get_varint(const unsigned char *in, size_t length, uint64_t *value);
+
+/// Returns the largest size of an encoded header
+/// \return Size in bytes
+size_t bitmap_snapshot_header_bound(void);
+
+/// Writes the header of a snapshot
+/// \param header Pointer to the header
+/// \param out Output buffer (at least bitmap_snapshot_header_bound() bytes)
+/// \return Number of written bytes
+size_t bitmap_snapshot_write_header(const bitmap_snapshot_header_t *header, unsigned char *out);
+
+/// Reads the header of a snapshot
+/// \param header Pointer to the header which will be filled
+/// \param in Input buffer
+/// \param length Number of bytes in the input
+/// \return Number of read bytes or 0 if the input is not a snapshot of this version
+size_t bitmap_snapshot_read_header(bitmap_snapshot_header_t *header, const unsigned char *in, size_t length);
+
+/// Returns the largest size of an encoded row (its encoding byte and the raw payload)
+/// \param cols Number of columns
+/// \return Size in bytes
+size_t bitmap_snapshot_row_bound(int cols);
+
+/// Encodes the words of a row with its smallest encoding
+/// \param data Words of the row
+/// \param cols Number of columns (a multiple of 8)
+/// \param out Output buffer (at least bitmap_snapshot_row_bound(cols) bytes)
+/// \return Number of written bytes
+size_t bitmap_snapshot_encode_row(const uint64_t *data, int cols, unsigned char *out);
+
+/// Decodes a row into its words
+/// \param in Input buffer
+/// \param length Number of bytes left in the input
+/// \param cols Number of columns (a multiple of 8)
+/// \param data Words of the row which will be filled
+/// \return Number of read bytes or 0 if the row is malformed
+size_t bitmap_snapshot_decode_row(const unsigned char *in, size_t length, int cols, uint64_t *data);
+
+#endif
@@ -0,0 +1,138 @@
+#include <stdint.h>
+#include <string.h>
+#include "bitmap.h"
+
+/* Summary engine: the rows of the array engine, indexed by block counts instead of the ranks of their words. Level 0
+ * counts the set bits of each block of BITMAP_SUMMARY_FANOUT words, each next level the set bits of
+ * BITMAP_SUMMARY_FANOUT blocks of the level below, up to one block holding the row. A bit of the non-empty masks tells
+ * whether a word has set bits. A select walks down the levels and a clear updates one count per level, so both take
+ * O(log t) steps, where the ranks of a row of t columns take t / 64 updates per clear. The counts and masks take
+ * about 1 / 14 of the words. */
+#define ARRAY_MATRIX(bm) (&(bm)->bitmap_matrix.summary.array)
+#define BITMAP_ROW_SUMMARY
+
+#include "bitmap_array_layout.h"
+
+
+static size_t bitmap_row_buffer_bytes(const bitmap_t *bm) {
+    const bitmap_summary_matrix_t *matrix = &bm->bitmap_matrix.summary;
+    return sizeof(uint64_t) * (bm->cW + matrix->masks) + sizeof(int) * matrix->counts;
+}
+
+
+static void bitmap_row_attach(const bitmap_t *bm, row_t *row, unsigned char *buffer) {
+    /* The words, then the masks and the block counts */
+    const bitmap_summary_matrix_t *matrix = &bm->bitmap_matrix.summary;
+    row->data = (uint64_t *) buffer;
+    row->nonempty = row->data + bm->cW;
+    row->rank = (int *) (row->nonempty + matrix->masks);
+}
+
+
+static int bitmap_row_summarize(const bitmap_t *bm, row_t *row) {
+    const bitmap_summary_matrix_t *matrix = &bm->bitmap_matrix.summary;
+    const uint64_t *data = row->data;
+    int *blocks = row->rank;
+    int set_bits = 0;
+    memset(row->nonempty, 0, sizeof(uint64_t) * matrix->masks);
+
+    /* One block at a time, its count and its byte of the masks in locals */
+    for (int block = 0; block < matrix->level_size[0]; block++) {
+        int first_word = block * BITMAP_SUMMARY_FANOUT, count = 0;
+        int end = min(first_word + BITMAP_SUMMARY_FANOUT, bm->cW);
+        uint64_t words = 0;
+        for (int w = first_word; w < end; w++) {
+            int bits = word_popcount(data[w]);
+            count += bits;
+            words |= (uint64_t) (bits > 0) << (w - first_word);
+        }
+        blocks[block] = count;
+        row->nonempty[first_word / 64] |= words << (first_word % 64);
+        set_bits += count;
+    }
+
+    /* Each block of a level sums its children in the level below */
+    for (int level = 1; level < matrix->levels; level++) {
+        const int *children = row->rank + matrix->level_offset[level - 1];
+        blocks = row->rank + matrix->level_offset[level];
+        memset(blocks, 0, sizeof(int) * matrix->level_size[level]);
+        for (int child = 0; child < matrix->level_size[level - 1]; child++)
+            blocks[child / BITMAP_SUMMARY_FANOUT] += children[child];
+    }
+    return set_bits;
+}
+
+
+static int bitmap_row_select(const bitmap_t *bm, const row_t *row, int target_index) {
+    /* Down from the block holding the row, into the child holding the target at each level */
+    const bitmap_summary_matrix_t *matrix = &bm->bitmap_matrix.summary;
+    int block = 0;
+    for (int level = matrix->levels - 2; level >= 0; level--) {
+        const int *blocks = row->rank + matrix->level_offset[level];
+        block *= BITMAP_SUMMARY_FANOUT;
+        while (target_index >= blocks[block])
+            target_index -= blocks[block++];
+    }
+
+    /* Then over the non-empty words of the block */
+    int first_word = block * BITMAP_SUMMARY_FANOUT;
+    uint64_t words = row->nonempty[first_word / 64] >> (first_word % 64) & ((1ULL << BITMAP_SUMMARY_FANOUT) - 1);
+    for (;; words &= words - 1) {
+        int word = first_word + __builtin_ctzll(words);
+        int bits = word_popcount(row->data[word]);
+        if (target_index < bits)
+            return word * 64 + word_select(row->data[word], target_index);
+        target_index -= bits;
+    }
+}
+
+
+static void bitmap_row_unset(const bitmap_t *bm, row_t *row, int col) {
+    const bitmap_summary_matrix_t *matrix = &bm->bitmap_matrix.summary;
+    int word = col / 64;
+    row->data[word] &= ~(1ULL << (col % 64));
+    if (!row->data[word])
+        row->nonempty[word / 64] &= ~(1ULL << (word % 64));
+    int block = word / BITMAP_SUMMARY_FANOUT;
+    for (int level = 0; level < matrix->levels; level++, block /= BITMAP_SUMMARY_FANOUT)
+        row->rank[matrix->level_offset[level] + block]--;
+}
+
+
+static int bitmap_row_take(const bitmap_t *bm, row_t *row, int target_index, int *cursor) {
+    /* The counts are exact after every clear, so the walk needs no cursor */
+    (void) cursor;
+    int col = bitmap_row_select(bm, row, target_index);
+    bitmap_row_unset(bm, row, col);
+    return col;
+}
+
+
+static void bitmap_row_settle(const bitmap_t *bm, row_t *row, int cursor) {
+    (void) bm;
+    (void) row;
+    (void) cursor;
+}
+
+
+/// Computes the shape of the block counts, then allocates the rows like the array engine
+/// \param bm Pointer to the bitmap structure
+/// \return BITMAP_INIT_SUCCESS or BITMAP_INIT_FAILED (an allocation failed, nothing stays allocated)
+static int bitmap_summary_init(bitmap_t *bm) {
+    bitmap_summary_matrix_t *matrix = &bm->bitmap_matrix.summary;
+    int blocks = bm->cW;
+    matrix->levels = 0;
+    matrix->counts = 0;
+    do {
+        blocks = (blocks + BITMAP_SUMMARY_FANOUT - 1) / BITMAP_SUMMARY_FANOUT;
+        matrix->level_offset[matrix->levels] = matrix->counts;
+        matrix->level_size[matrix->levels++] = blocks;
+        matrix->counts += blocks;
+    } while (blocks > 1);
+    matrix->masks = (bm->cW + 63) / 64;
+    return bitmap_array_layout_init(bm);
+}
+
+
+const bitmap_engine_t bitmap_summary_engine = BITMAP_ENGINE_OPS("summary", bitmap_summary_init,
+                                                                bitmap_array_layout_destroy);
@@ -0,0 +1,607 @@
+#ifndef MUMHORS_BITMAP_WINDOW_H
+#define MUMHORS_BITMAP_WINDOW_H
+
+/* Window operations shared by the bitmap engines (selection, clearing, allocation and eviction policy). They only
+ * see the rows through what the including engine defines before including this file:
+ *     ENGINE_MATRIX(bm)                 Pointer to the matrix of the engine (with free_slots and free_count)
+ *     ROW_NUMBER(bm, row, position)     Row number of a row (an lvalue)
+ *     ROW_SET_BITS(bm, row, position)   Set bits of a row (an lvalue)
+ *     ROW_SLOT(bm, row, position)       Eviction heap id of a row
+ *     bitmap_row_at(bm, position)       Active row at a window position
+ * and the engine functions declared below. Inside a row, the words are found through their ranks, unless the engine
+ * defines BITMAP_ROW_SUMMARY and the row functions declared below with its own index of the words. Every function is
+ * static, so each engine gets its own copy with its row accesses inlined. */
+
+#include <stdio.h>
+#include <sys/time.h>
+#include "bitmap.h"
+#include "bitmap_snapshot.h"
+#include "mumhors_math.h"
+
+#ifdef JOURNAL
+static struct timeval start_time, end_time;
+#endif
+
+/// Rebuilds the window indexes after rows were removed from the window (defined by the engine)
+/// \param bm Pointer to the bitmap structure
+static void bitmap_index_rebuild(bitmap_t *bm);
+
+/// Removes the rows that have no set bits left (defined by the engine)
+/// \param bm Pointer to the bitmap structure
+/// \return Number of removed rows
+static int bitmap_row_cleanup(bitmap_t *bm);
+
+/// Removes the active row at a window position, without rebuilding the indexes (defined by the engine)
+/// \param bm Pointer to the bitmap structure
+/// \param position Window position of the row
+static void bitmap_engine_remove_row(bitmap_t *bm, int position);
+
+/// Adds a full row numbered nxt_row_number at the end of the window (defined by the engine)
+/// \param bm Pointer to the bitmap structure
+static void bitmap_engine_add_row(bitmap_t *bm);
+
+
+/// Builds the index of the words of a row from its words (the ranks, or the engine's with BITMAP_ROW_SUMMARY)
+/// \param bm Pointer to the bitmap structure
+/// \param row Pointer to the row
+/// \return Number of set bits of the row
+static int bitmap_row_summarize(const bitmap_t *bm, row_t *row);
+
+/// Returns the column of the target_index'th set bit of a row
+/// \param bm Pointer to the bitmap structure
+/// \param row Pointer to the row
+/// \param target_index Index of the set bit in the row (smaller than the row's set bits)
+/// \return Column number
+static int bitmap_row_select(const bitmap_t *bm, const row_t *row, int target_index);
+
+/// Unsets a column of a row and updates the index of its words
+/// \param bm Pointer to the bitmap structure
+/// \param row Pointer to the row
+/// \param col Column number (must be set)
+static void bitmap_row_unset(const bitmap_t *bm, row_t *row, int col);
+
+/// Unsets the target_index'th set bit of a row, for a walk down the set bits of the row in descending order. The
+/// index of the words may lag behind until bitmap_row_settle.
+/// \param bm Pointer to the bitmap structure
+/// \param row Pointer to the row
+/// \param target_index Index of the set bit in the row (below the ones taken before in the walk)
+/// \param cursor Pointer to the position of the walk (the last word of the row at the start)
+/// \return Column number
+static int bitmap_row_take(const bitmap_t *bm, row_t *row, int target_index, int *cursor);
+
+/// Brings the index of the words of a row up to date after a walk of bitmap_row_take
+/// \param bm Pointer to the bitmap structure
+/// \param row Pointer to the row
+/// \param cursor Position of the walk
+static void bitmap_row_settle(const bitmap_t *bm, row_t *row, int cursor);
+
+
+/// Sets all the columns of a row and numbers it
+/// \param bm Pointer to the bitmap structure
+/// \param row Pointer to the row
+/// \param position Window position of the row
+/// \param number Row number
+static void bitmap_fill_row(bitmap_t *bm, row_t *row, int position, long long number) {
+    (void) position;
+    ROW_NUMBER(bm, row, position) = number;
+    ROW_SET_BITS(bm, row, position) = bm->c;
+    for (int w = 0; w < bm->cW; w++)
+        row->data[w] = ~0ULL;
+    /* Columns past the end of the row stay unset */
+    if (bm->c % 64)
+        row->data[bm->cW - 1] = (1ULL << (bm->c % 64)) - 1;
+    bitmap_row_summarize(bm, row);
+}
+
+
+#ifndef BITMAP_ROW_SUMMARY
+static int bitmap_row_summarize(const bitmap_t *bm, row_t *row) {
+    int set_bits = 0;
+    for (int w = 0; w < bm->cW; w++) {
+        row->rank[w] = set_bits;
+        set_bits += word_popcount(row->data[w]);
+    }
+    return set_bits;
+}
+
+static int bitmap_row_select(const bitmap_t *bm, const row_t *row, int target_index) {
+    /* The last word whose rank does not exceed the target holds it (empty words share the rank of the next one) */
+    int low = 0, high = bm->cW - 1;
+    while (low < high) {
+        int mid = (low + high + 1) / 2;
+        if (row->rank[mid] <= target_index)
+            low = mid;
+        else
+            high = mid - 1;
+    }
+    return low * 64 + word_select(row->data[low], target_index - row->rank[low]);
+}
+
+static void bitmap_row_unset(const bitmap_t *bm, row_t *row, int col) {
+    row->data[col / 64] &= ~(1ULL << (col % 64));
+    for (int w = col / 64 + 1; w < bm->cW; w++)
+        row->rank[w]--;
+}
+
+static int bitmap_row_take(const bitmap_t *bm, row_t *row, int target_index, int *cursor) {
+    (void) bm;
+    /* The ranks of the words below the cursor are still exact, so the walk goes down to the word holding the target */
+    int word = *cursor;
+    while (row->rank[word] > target_index)
+        word--;
+    int bit = word_select(row->data[word], target_index - row->rank[word]);
+    row->data[word] &= ~(1ULL << bit);
+    *cursor = word;
+    return word * 64 + bit;
+}
+
+static void bitmap_row_settle(const bitmap_t *bm, row_t *row, int cursor) {
+    for (int w = cursor + 1; w < bm->cW; w++)
+        row->rank[w] = row->rank[w - 1] + word_popcount(row->data[w - 1]);
+}
+#endif
+
+
+/// Unsets a column of a row
+/// \param bm Pointer to the bitmap structure
+/// \param row Pointer to the row
+/// \param position Window position of the row
+/// \param col Column number (must be set)
+static void bitmap_row_clear(bitmap_t *bm, row_t *row, int position, int col) {
+    (void) position;
+    bitmap_row_unset(bm, row, col);
+    ROW_SET_BITS(bm, row, position)--;
+    bm->set_bits--;
+    minheap_decrease(&bm->eviction_heap, ROW_SLOT(bm, row, position), 1);
+}
+
+
+/// Adds a new (full) row at the end of the window: in the Fenwick tree and in the eviction heap
+/// \param bm Pointer to the bitmap structure
+/// \param row Pointer to the new row
+/// \param position Window position of the new row (the current number of rows in the Fenwick tree)
+static void bitmap_index_append(bitmap_t *bm, row_t *row, int position) {
+    (void) row;
+    (void) position;
+    fenwick_append(&bm->set_bits_index, ROW_SET_BITS(bm, row, position));
+    minheap_push(&bm->eviction_heap, ROW_SLOT(bm, row, position), ROW_SET_BITS(bm, row, position),
+                 ROW_NUMBER(bm, row, position));
+}
+
+
+/// Takes a removed row out of the eviction heap and frees its slot for the next allocations
+/// \param bm Pointer to the bitmap structure
+/// \param slot Slot of the row
+static void bitmap_release_slot(bitmap_t *bm, int slot) {
+    minheap_remove(&bm->eviction_heap, slot);
+    ENGINE_MATRIX(bm)->free_slots[ENGINE_MATRIX(bm)->free_count++] = slot;
+}
+
+
+/// Takes a free slot for a new row
+/// \param bm Pointer to the bitmap structure
+/// \return Slot
+static int bitmap_acquire_slot(bitmap_t *bm) {
+    return ENGINE_MATRIX(bm)->free_slots[--ENGINE_MATRIX(bm)->free_count];
+}
+
+
+/// Returns the window position of an active row in O(log rt) (the window is sorted by row number)
+/// \param bm Pointer to the bitmap structure
+/// \param number Row number of an active row
+/// \return Window position
+static int bitmap_window_position(bitmap_t *bm, long long number) {
+    int low = 0, high = bm->active_rows - 1;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (ROW_NUMBER(bm, bitmap_row_at(bm, mid), mid) < number)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+
+/// Finds the active row holding the target index in O(log rt)
+/// \param bm Pointer to the bitmap structure
+/// \param target_index Pointer to the index in the window. It is replaced by the index inside the row.
+/// \param position Pointer to variable which will store the window position of the row
+/// \return Pointer to the row
+static row_t *bitmap_find_row(bitmap_t *bm, int *target_index, int *position) {
+    *position = fenwick_find(&bm->set_bits_index, target_index);
+    return bitmap_row_at(bm, *position);
+}
+
+
+/// Evicts rows from the window following the eviction policy of the bitmap, without rebuilding the indexes
+/// \param bm Pointer to the bitmap structure
+static void bitmap_window_evict(bitmap_t *bm) {
+    int victims[bm->active_rows], evicted = 1;
+    if (bm->eviction_policy == EVICTION_FEWEST) {
+        /* The top of the eviction heap is the first row with the fewest set bits */
+        victims[0] = bitmap_window_position(bm, bm->eviction_heap.numbers[minheap_top(&bm->eviction_heap)]);
+    } else {
+        int counts[bm->active_rows];
+        for (int position = 0; position < bm->active_rows; position++)
+            counts[position] = ROW_SET_BITS(bm, bitmap_row_at(bm, position), position);
+        evicted = eviction_select(bm->eviction_policy, bm->eviction_param, counts, bm->active_rows, victims);
+    }
+
+    /* From the last victim, so the positions of the others stay valid */
+    for (int i = 0; i < evicted; i++) {
+#ifdef JOURNAL
+        bm->bitmap_report.cnt_call_direct_remove_row++;
+#endif
+        bitmap_engine_remove_row(bm, victims[i]);
+    }
+}
+
+
+/// Adds the first rt rows of the bitmap (the layout of the engine is ready)
+/// \param bm Pointer to the bitmap structure
+static void bitmap_window_init_rows(bitmap_t *bm) {
+    for (int i = 0; i < bm->rt; i++) {
+        bitmap_engine_add_row(bm);
+        bm->nxt_row_number++;
+    }
+}
+
+
+/// Allocate more new rows
+/// \param bm Pointer to the bitmap structure
+/// \return BITMAP_MORE_ROW_ALLOCATION_SUCCESS or BITMAP_NO_MORE_ROWS_TO_ALLOCATE
+static int bitmap_allocate_more_row(bitmap_t *bm) {
+#ifdef JOURNAL
+    bm->bitmap_report.cnt_call_alloc_more_rows_call++;
+#endif
+
+    /* Check if we have any row left to allocate */
+    if (bm->nxt_row_number >= bm->r)
+        return BITMAP_NO_MORE_ROWS_TO_ALLOCATE;
+
+    /* Check if allocating a new row will pass the limit of active rows (again after the limit shrank) */
+    long long discarded_bits = bm->discarded_bits;
+    while (bm->active_rows + 1 > bm->row_limit.limit) {
+        /* Perform a cleanup to remove rows that have no set bits.
+         * If the cleanup is not successful, remove the row with
+         * the least number of set bits if no row was deleted */
+        if (!bitmap_row_cleanup(bm)) {
+            /* Clean up did not clean anything. So, evicting rows with set bits */
+            bitmap_window_evict(bm);
+        }
+        /* The remaining rows moved to new window positions */
+        bitmap_index_rebuild(bm);
+    }
+
+    /* Possible number of rows to allocate */
+    int possible_number_of_rows = bm->row_limit.limit - bm->active_rows;
+    if (bm->r - bm->nxt_row_number < possible_number_of_rows)
+        possible_number_of_rows = (int) (bm->r - bm->nxt_row_number);
+    bm->active_rows += possible_number_of_rows;
+    bm->set_bits += bm->c * possible_number_of_rows;
+
+    for (int i = 0; i < possible_number_of_rows; i++) {
+        bitmap_engine_add_row(bm);
+
+        /* Updating the hyperparameters */
+        bm->nxt_row_number++;
+    }
+    row_limit_update(&bm->row_limit, possible_number_of_rows, bm->discarded_bits - discarded_bits, bm->c);
+    return BITMAP_MORE_ROW_ALLOCATION_SUCCESS;
+}
+
+
+/// Extending the bitmap to hold more 1s (bitmap_extend_matrix)
+/// \param bm Pointer to the bitmap structure
+/// \return BITMAP_EXTENSION_SUCCESS or BITMAP_EXTENSION_FAILED
+static int bitmap_window_extend(bitmap_t *bm) {
+    /* If there are not enough 1s in the current window, extend the matrix with the headroom. The window cannot hold
+     * more than the rows that stay while one is replaced, so the headroom is cut to them. */
+    if (bm->window_size > bm->set_bits) {
+        do {
+            if (bitmap_allocate_more_row(bm) == BITMAP_NO_MORE_ROWS_TO_ALLOCATE)
+                break;
+        } while (bm->set_bits < min(bm->window_size + bm->headroom, (bm->row_limit.limit - 1) * bm->c));
+        if (bm->window_size > bm->set_bits)
+            return BITMAP_EXTENSION_FAILED;
+    }
+    return BITMAP_EXTENSION_SUCCESS;
+}
+
+
+/// Returns the row and colum number of the given bit index (bitmap_get_row_colum_with_index)
+/// \param bm Pointer to the bitmap structure
+/// \param target_index Target index for which we want the row and column numbers
+/// \param row_num Pointer to variable which will store the row number
+/// \param col_num Pointer to variable which will store the column number
+static void bitmap_window_select(bitmap_t *bm, int target_index, long long *row_num, int *col_num) {
+#ifdef JOURNAL
+    bm->bitmap_report.cnt_cnt_get_row_col_call++;
+    gettimeofday(&start_time, NULL);
+#endif
+
+    /* Find the row containing our desired index */
+    int position;
+    row_t *row = bitmap_find_row(bm, &target_index, &position);
+
+    /* The current row contains the desired index */
+    *row_num = ROW_NUMBER(bm, row, position);
+    *col_num = bitmap_row_select(bm, row, target_index);
+#ifdef JOURNAL
+    gettimeofday(&end_time, NULL);
+    bm->bitmap_report.total_time_get_row_col += (end_time.tv_sec - start_time.tv_sec) + (
+        end_time.tv_usec - start_time.tv_usec) / 1.0e6;
+#endif
+}
+
+
+/// Unsetting the passed indices (bitmap_unset_indices_in_window)
+/// \param bm Pointer to the bitmap structure
+/// \param indices Array of indices to be unset (descending order)
+/// \param num_index Number of passed indices
+static void bitmap_window_unset(bitmap_t *bm, int *indices, int num_index) {
+#ifdef JOURNAL
+    bm->bitmap_report.cnt_cnt_unset_call++;
+    gettimeofday(&start_time, NULL);
+#endif
+
+    /* Sort the indices.
+     * Description: The rationale behind first soring and then unsetting is that, when the indices
+     * are given in not-ordered fashion, then if we try to unset the first one, we loose the information
+     * for the next index. For instance, if the set {5, 7, 10} is given, when we unset 5, the bit at index 7
+     * becomes index 7 and the 10 becomes 8. But this is more complicated because if the set is {5, 1, 10}, then
+     * unsetting 5, will not impact 1 but impacts 7 and changes it to 9 but not even 8. Sorting the indices can
+     * resolve this issue. However, for the usage in MUM-HORS, we shall not provide a sorted value back. So either
+     * we should maintain a data structure that returns back the actual order before sorting, or, first perform
+     * fetching the values and then remove the indices.
+     * */
+
+    for (int i = 0; i < num_index; i++) {
+        int target_index = indices[i];
+
+        /* Find the row containing our desired index */
+        int position;
+        row_t *row = bitmap_find_row(bm, &target_index, &position);
+
+        /* The current row contains the desired index */
+        bitmap_row_clear(bm, row, position, bitmap_row_select(bm, row, target_index));
+        fenwick_add(&bm->set_bits_index, position, -1);
+    }
+
+#ifdef JOURNAL
+    gettimeofday(&end_time, NULL);
+    bm->bitmap_report.total_time_unset_bits += (end_time.tv_sec - start_time.tv_sec) + (
+        end_time.tv_usec - start_time.tv_usec) / 1.0e6;
+#endif
+}
+
+
+/// Applies the bits cleared in a row by bitmap_window_select_and_clear to its counters and word index
+/// \param bm Pointer to the bitmap structure
+/// \param row Pointer to the row
+/// \param position Window position of the row
+/// \param cleared Number of cleared bits
+/// \param cursor Position of the walk over the row
+static void bitmap_row_commit_clears(bitmap_t *bm, row_t *row, int position, int cleared, int cursor) {
+    ROW_SET_BITS(bm, row, position) -= cleared;
+    bm->set_bits -= cleared;
+    minheap_decrease(&bm->eviction_heap, ROW_SLOT(bm, row, position), cleared);
+    fenwick_add(&bm->set_bits_index, position, -cleared);
+    bitmap_row_settle(bm, row, cursor);
+}
+
+
+/// Finds the row and column numbers of a set of indices and unsets them (bitmap_select_and_clear)
+/// \param bm Pointer to the bitmap structure
+/// \param indices Array of distinct indices (message order)
+/// \param sorted_indices The same indices in descending order
+/// \param num_index Number of passed indices
+/// \param row_nums Array which will store the row number of each index (message order)
+/// \param col_nums Array which will store the column number of each index (message order)
+static void bitmap_window_select_and_clear(bitmap_t *bm, const int *indices, const int *sorted_indices,
+                                           int num_index, long long *row_nums, int *col_nums) {
+#ifdef JOURNAL
+    bm->bitmap_report.cnt_batch_call++;
+    gettimeofday(&start_time, NULL);
+#endif
+
+    /* Going down the sorted indices, clearing a bit only moves the indices above it, which are done already.
+     * The rows are visited from the last one and the words of each row from its last word, each at most once.
+     * The counters and the word index of a row are updated once, when the walk leaves it. */
+    long long sorted_rows[num_index], number = 0;
+    int sorted_cols[num_index];
+    row_t *row = NULL;
+    int position = 0, base = 0, cursor = 0, cleared = 0;
+    for (int i = 0; i < num_index; i++) {
+        int target_index = sorted_indices[i];
+
+        if (!row || target_index < base) {
+            if (row)
+                bitmap_row_commit_clears(bm, row, position, cleared, cursor);
+            int in_row = target_index;
+            position = fenwick_find(&bm->set_bits_index, &in_row);
+            row = bitmap_row_at(bm, position);
+            number = ROW_NUMBER(bm, row, position);
+            base = target_index - in_row; /* Set bits of the rows before this one */
+            cursor = bm->cW - 1;
+            cleared = 0;
+        }
+
+        sorted_rows[i] = number;
+        sorted_cols[i] = bitmap_row_take(bm, row, target_index - base, &cursor);
+        cleared++;
+    }
+    if (row)
+        bitmap_row_commit_clears(bm, row, position, cleared, cursor);
+
+    /* Back to the message order: the sorted position of an index is the number of indices above it (counted
+     * without branches, so the compiler vectorizes it) */
+    for (int i = 0; i < num_index; i++) {
+        int sorted_position = 0;
+        for (int j = 0; j < num_index; j++)
+            sorted_position += indices[j] > indices[i];
+        row_nums[i] = sorted_rows[sorted_position];
+        col_nums[i] = sorted_cols[sorted_position];
+    }
+
+#ifdef JOURNAL
+    gettimeofday(&end_time, NULL);
+    bm->bitmap_report.total_time_batch += (end_time.tv_sec - start_time.tv_sec) + (
+        end_time.tv_usec - start_time.tv_usec) / 1.0e6;
+#endif
+}
+
+
+/// Removes an active row from the window and rebuilds the indexes (bitmap_remove_row)
+/// \param bm Pointer to the bitmap structure
+/// \param position Window position of the row
+static void bitmap_window_remove(bitmap_t *bm, int position) {
+    bitmap_engine_remove_row(bm, position);
+    bitmap_index_rebuild(bm);
+}
+
+
+/// Writes the active rows of a snapshot: the gap from the previous row number and the encoded row
+/// \param bm Pointer to the bitmap structure
+/// \param buffer Output buffer
+/// \return Number of written bytes
+static size_t bitmap_window_snapshot(const bitmap_t *bm, unsigned char *buffer) {
+    bitmap_t *window = (bitmap_t *) bm; /* Only read */
+    size_t written = 0;
+    long long previous = -1;
+    for (int position = 0; position < bm->active_rows; position++) {
+        row_t *row = bitmap_row_at(window, position);
+        long long number = ROW_NUMBER(window, row, position);
+        written += bitmap_snapshot_put_varint(buffer + written, number - previous - 1);
+        written += bitmap_snapshot_encode_row(row->data, bm->c, buffer + written);
+        previous = number;
+    }
+    return written;
+}
+
+
+/// Replaces the rows of a new bitmap by the rows of a snapshot (bitmap_restore)
+/// \param bm Pointer to the bitmap structure (just initialized with the hyperparameters of the snapshot)
+/// \param rows Active rows of the snapshot
+/// \param length Number of bytes of the rows
+/// \param active_rows Number of active rows
+/// \param nxt_row_number Next row number of the snapshot
+/// \return BITMAP_RESTORE_SUCCESS or BITMAP_RESTORE_FAILED
+static int bitmap_window_restore(bitmap_t *bm, const unsigned char *rows, size_t length, int active_rows,
+                                 long long nxt_row_number) {
+    /* Drop the rows of bitmap_init from the last one, so their slots are taken again in order */
+    while (bm->active_rows)
+        bitmap_engine_remove_row(bm, bm->active_rows - 1);
+    bitmap_index_rebuild(bm);
+
+    /* Each row is added full and overwritten with its bits, then its word index and counters follow from the words */
+    size_t read = 0;
+    long long number = -1;
+    bm->set_bits = 0;
+    for (int position = 0; position < active_rows; position++) {
+        uint64_t gap;
+        int gap_bytes = bitmap_snapshot_get_varint(rows + read, length - read, &gap);
+        if (!gap_bytes || gap >= (uint64_t) (nxt_row_number - number - 1))
+            return BITMAP_RESTORE_FAILED;
+        read += gap_bytes;
+        number += gap + 1;
+
+        bm->nxt_row_number = number;
+        bitmap_engine_add_row(bm);
+        bm->active_rows++;
+        row_t *row = bitmap_row_at(bm, position);
+        size_t row_bytes = bitmap_snapshot_decode_row(rows + read, length - read, bm->c, row->data);
+        if (!row_bytes)
+            return BITMAP_RESTORE_FAILED;
+        read += row_bytes;
+
+        int set_bits = bitmap_row_summarize(bm, row);
+        ROW_SET_BITS(bm, row, position) = set_bits;
+        minheap_decrease(&bm->eviction_heap, ROW_SLOT(bm, row, position), bm->c - set_bits);
+        bm->set_bits += set_bits;
+    }
+    if (read != length)
+        return BITMAP_RESTORE_FAILED;
+
+    bm->nxt_row_number = nxt_row_number;
+    bitmap_index_rebuild(bm);
+    /* The rows dropped above were not discarded */
+    bm->discarded_bits = 0;
+    bm->discarded_rows = 0;
+#ifdef JOURNAL
+    bm->bitmap_report.total_time_remove_row = 0;
+#endif
+    return BITMAP_RESTORE_SUCCESS;
+}
+
+
+#ifdef JOURNAL
+/// Presents a report of the bitmap performance (bitmap_report)
+/// \param bm Pointer to the bitmap structure
+static void bitmap_window_report(const bitmap_t *bm) {
+    printf("\n================ Bitmap Report ================\n");
+    printf("Engine: %s\n", bm->engine->name);
+    printf("Eviction: %s (%d)\n", eviction_policy_names[bm->eviction_policy], bm->eviction_param);
+    printf("Row limit: %d (%d-%d rows, %d adjustments)\n", bm->row_limit.limit, bm->row_limit.min, bm->row_limit.max,
+           bm->row_limit.adjustments);
+    printf("#ROW_ALLOC(.): %lld\n", bm->bitmap_report.cnt_call_alloc_more_rows_call);
+    printf("\t#ROW_CLEANUP(.): %lld\n", bm->bitmap_report.cnt_call_cleanup_call);
+    printf("\t\t--- Empty rows removed: %lld\n", bm->bitmap_report.cnt_call_cleanup_rows_removed);
+    printf("\t#ROW_DIRECT_REMOVE(.): %lld\n", bm->bitmap_report.cnt_call_direct_remove_row);
+    printf("#INDEX_GET_ROW_COL(.)/Index: %lld\n", bm->bitmap_report.cnt_cnt_get_row_col_call);
+    printf("#INDEX_UNSET(.)/Batch: %lld\n", bm->bitmap_report.cnt_cnt_unset_call);
+    printf("#SELECT_AND_CLEAR(.)/Batch: %lld\n", bm->bitmap_report.cnt_batch_call);
+    printf("--- Discarded rows: %lld/%lld\n", bm->discarded_rows, bm->r);
+    printf("--- Discarded bits: %lld/%lld\n", bm->discarded_bits, bm->r * bm->c);
+
+    /* Timing */
+    printf("\n------- Timings -------\n");
+    printf("--- TT Cleanup: %0.12f micros\n", bm->bitmap_report.total_time_cleanup * 1000000);
+    printf("--- TT Direct Remove Row: %0.12f micros\n", bm->bitmap_report.total_time_remove_row * 1000000);
+    printf("--- TT Get Row Col: %0.12f micros\n", bm->bitmap_report.total_time_get_row_col * 1000000);
+    printf("--- TT Unset Bits: %0.12f micros\n", bm->bitmap_report.total_time_unset_bits * 1000000);
+    printf("--- TT Select And Clear: %0.12f micros\n", bm->bitmap_report.total_time_batch * 1000000);
+
+    printf("\n");
+    printf("--- AVGT Cleanup: %0.12f micros\n", bm->bitmap_report.cnt_call_cleanup_rows_removed != 0
+                                                    ? bm->bitmap_report.total_time_cleanup / bm->bitmap_report.
+                                                      cnt_call_cleanup_rows_removed * 1000000
+                                                    : 0);
+
+    printf("--- AVGT Direct Remove Row: %0.12f micros\n",
+           (bm->bitmap_report.cnt_call_cleanup_rows_removed + bm->bitmap_report.cnt_call_direct_remove_row) != 0
+               ? bm->bitmap_report.total_time_remove_row / (
+                     bm->bitmap_report.cnt_call_direct_remove_row + bm->bitmap_report.cnt_call_cleanup_rows_removed) *
+                 1000000
+               : 0);
+
+    printf("--- AVGT Get Row Col: %0.12f micros\n", bm->bitmap_report.cnt_cnt_get_row_col_call != 0
+                                                        ? bm->bitmap_report.total_time_get_row_col / bm->bitmap_report.
+                                                          cnt_cnt_get_row_col_call * 1000000
+                                                        : 0);
+    printf("--- AVGT Unset Bits: %0.12f micros\n", bm->bitmap_report.cnt_cnt_unset_call != 0
+                                                       ? bm->bitmap_report.total_time_unset_bits / bm->bitmap_report.
+                                                         cnt_cnt_unset_call * 1000000
+                                                       : 0);
+    printf("--- AVGT Select And Clear: %0.12f micros\n", bm->bitmap_report.cnt_batch_call != 0
+                                                             ? bm->bitmap_report.total_time_batch / bm->bitmap_report.
+                                                               cnt_batch_call * 1000000
+                                                             : 0);
+}
+#endif
+
+
+/* Ops table of an engine from the shared window operations and its init/destroy functions */
+#ifdef JOURNAL
+#define BITMAP_ENGINE_OPS(engine_name, init_function, destroy_function) \
+    {engine_name, init_function, destroy_function, bitmap_window_extend, bitmap_window_select, bitmap_window_unset, \
+     bitmap_window_select_and_clear, bitmap_window_remove, bitmap_window_snapshot, bitmap_window_restore, \
+     bitmap_window_report}
+#else
+#define BITMAP_ENGINE_OPS(engine_name, init_function, destroy_function) \
+    {engine_name, init_function, destroy_function, bitmap_window_extend, bitmap_window_select, bitmap_window_unset, \
+     bitmap_window_select_and_clear, bitmap_window_remove, bitmap_window_snapshot, bitmap_window_restore}
+#endif
+
+#endif
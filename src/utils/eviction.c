@@ -0,0 +1,62 @@
+#include "eviction.h"
+#include <string.h>
+
+const char *const eviction_policy_names[EVICTION_NUM_POLICIES] = {"fewest", "oldest", "below", "batch"};
+
+int eviction_policy_find(const char *name) {
+    for (int policy = 0; policy < EVICTION_NUM_POLICIES; policy++) {
+        if (strcmp(eviction_policy_names[policy], name) == 0)
+            return policy;
+    }
+    return -1;
+}
+
+
+/// Returns the first position with the fewest set bits among the rows not chosen yet
+/// \param counts Set bits of the rows
+/// \param rows Number of rows
+/// \param chosen Whether each row is chosen already (NULL if none is)
+/// \return Position
+static int eviction_fewest(const int *counts, int rows, const char *chosen) {
+    int fewest = -1;
+    for (int position = 0; position < rows; position++) {
+        if ((!chosen || !chosen[position]) && (fewest < 0 || counts[position] < counts[fewest]))
+            fewest = position;
+    }
+    return fewest;
+}
+
+int eviction_select(int policy, int param, const int *counts, int rows, int *victims) {
+    int evicted = 0;
+    switch (policy) {
+        case EVICTION_OLDEST:
+            victims[evicted++] = 0;
+            break;
+        case EVICTION_BELOW:
+            for (int position = rows - 1; position >= 0; position--) {
+                if (counts[position] <= param)
+                    victims[evicted++] = position;
+            }
+            break;
+        case EVICTION_BATCH: {
+            /* The fewest rows one at a time (the batch is a handful of rows), then collected in descending order */
+            int batch = param < 1 ? 1 : param > rows ? rows : param;
+            char chosen[rows];
+            memset(chosen, 0, rows);
+            for (int i = 0; i < batch; i++)
+                chosen[eviction_fewest(counts, rows, chosen)] = 1;
+            for (int position = rows - 1; position >= 0; position--) {
+                if (chosen[position])
+                    victims[evicted++] = position;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    /* EVICTION_FEWEST, and the fallback of a threshold that no row is below */
+    if (!evicted)
+        victims[evicted++] = eviction_fewest(counts, rows, NULL);
+    return evicted;
+}
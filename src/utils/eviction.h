@@ -0,0 +1,30 @@
+#ifndef MUMHORS_EVICTION_H
+#define MUMHORS_EVICTION_H
+
+/* Eviction policies: the rows that leave a full window which has no empty row. The signer's bitmap and the verifier
+ * must use the same policy (and parameter) to keep the same window. */
+#define EVICTION_FEWEST 0 /* The first row with the fewest set bits */
+#define EVICTION_OLDEST 1 /* The first row of the window (the smallest row number) */
+#define EVICTION_BELOW 2  /* Every row with at most `param` set bits, or the fewest if there is none */
+#define EVICTION_BATCH 3  /* The `param` rows with the fewest set bits (ties to the first ones) */
+#define EVICTION_NUM_POLICIES 4
+
+/* Names of the policies, by id */
+extern const char *const eviction_policy_names[EVICTION_NUM_POLICIES];
+
+/// Returns the id of the policy with the given name
+/// \param name Name of the policy
+/// \return Policy id or -1 if there is no such policy
+int eviction_policy_find(const char *name);
+
+/// Chooses the rows to evict from a window
+/// \param policy Policy id
+/// \param param Parameter of the policy (threshold of EVICTION_BELOW, number of rows of EVICTION_BATCH)
+/// \param counts Set bits (available keys) of the rows in window order
+/// \param rows Number of rows in the window (at least one)
+/// \param victims Array which will store the window positions of the rows to evict, in descending order (so the
+/// rows can be removed one after the other without moving the positions of the next ones)
+/// \return Number of rows to evict (at least one)
+int eviction_select(int policy, int param, const int *counts, int rows, int *victims);
+
+#endif
@@ -0,0 +1,60 @@
+#include "fenwick.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define LOWBIT(i) ((i) & -(i))
+
+int fenwick_init(fenwick_t *fw, int capacity) {
+    fw->size = 0;
+    fw->capacity = capacity;
+    fw->tree = calloc(capacity + 1, sizeof(int));
+    return fw->tree ? 0 : -1;
+}
+
+void fenwick_delete(fenwick_t *fw) {
+    free(fw->tree);
+}
+
+void fenwick_build(fenwick_t *fw, const int *counts, int size) {
+    fw->size = size;
+    memcpy(fw->tree + 1, counts, sizeof(int) * size);
+
+    /* Every node pushes its sum to its parent */
+    for (int i = 1; i <= size; i++) {
+        int parent = i + LOWBIT(i);
+        if (parent <= size)
+            fw->tree[parent] += fw->tree[i];
+    }
+}
+
+void fenwick_append(fenwick_t *fw, int count) {
+    int i = ++fw->size;
+
+    /* The new node covers (i - lowbit(i), i]: its count plus the nodes of that range before it */
+    fw->tree[i] = count;
+    for (int j = i - 1; j > i - LOWBIT(i); j -= LOWBIT(j))
+        fw->tree[i] += fw->tree[j];
+}
+
+void fenwick_add(fenwick_t *fw, int position, int delta) {
+    for (int i = position + 1; i <= fw->size; i += LOWBIT(i))
+        fw->tree[i] += delta;
+}
+
+int fenwick_find(const fenwick_t *fw, int *target_index) {
+    /* Descend from the highest power of two, skipping every node whose sum does not exceed the target */
+    int step = 1;
+    while (step * 2 <= fw->size)
+        step *= 2;
+
+    int position = 0;
+    int remaining = *target_index;
+    for (; step; step /= 2) {
+        if (position + step <= fw->size && fw->tree[position + step] <= remaining) {
+            position += step;
+            remaining -= fw->tree[position];
+        }
+    }
+    *target_index = remaining;
+    return position;
+}
@@ -0,0 +1,46 @@
+#ifndef MUMHORS_FENWICK_H
+#define MUMHORS_FENWICK_H
+
+/// Fenwick (binary indexed) tree over a sequence of non-negative counts. It gives the position holding the n-th
+/// unit of the total in O(log n), which is how the bitmap and the verifier find the row of an index.
+typedef struct fenwick {
+    int size;       /* Number of counts in the sequence */
+    int capacity;   /* Maximum number of counts */
+    int *tree;      /* 1-based tree, tree[i] sums the counts (i - lowbit(i), i] */
+} fenwick_t;
+
+/// Initializes an empty Fenwick tree
+/// \param fw Pointer to the Fenwick tree
+/// \param capacity Maximum number of counts
+/// \return 0, or -1 if the tree cannot be allocated
+int fenwick_init(fenwick_t *fw, int capacity);
+
+/// Deletes the Fenwick tree
+/// \param fw Pointer to the Fenwick tree
+void fenwick_delete(fenwick_t *fw);
+
+/// Replaces the sequence by the given counts in O(n)
+/// \param fw Pointer to the Fenwick tree
+/// \param counts Array of counts
+/// \param size Number of counts (at most the capacity)
+void fenwick_build(fenwick_t *fw, const int *counts, int size);
+
+/// Appends a count at the end of the sequence in O(log n)
+/// \param fw Pointer to the Fenwick tree
+/// \param count Count to append
+void fenwick_append(fenwick_t *fw, int count);
+
+/// Adds a delta to the count at a position in O(log n)
+/// \param fw Pointer to the Fenwick tree
+/// \param position Position of the count (0-based)
+/// \param delta Value to add
+void fenwick_add(fenwick_t *fw, int position, int delta);
+
+/// Finds the position holding the target_index'th unit of the total in O(log n)
+/// \param fw Pointer to the Fenwick tree
+/// \param target_index Pointer to the index (smaller than the total). It is replaced by the index inside the
+/// count of the returned position.
+/// \return Position (0-based)
+int fenwick_find(const fenwick_t *fw, int *target_index);
+
+#endif
@@ -0,0 +1,100 @@
+#include "minheap.h"
+#include <stdlib.h>
+
+/* Whether the row of id a goes above the row of id b */
+#define MINHEAP_BEFORE(mh, a, b) ((mh)->counts[a] < (mh)->counts[b] || \
+    ((mh)->counts[a] == (mh)->counts[b] && (mh)->numbers[a] < (mh)->numbers[b]))
+
+/// Places an id at a heap index
+/// \param mh Pointer to the heap
+/// \param index Heap index
+/// \param id Id of the row
+static void minheap_place(minheap_t *mh, int index, int id) {
+    mh->heap[index] = id;
+    mh->location[id] = index;
+}
+
+/// Moves the id at a heap index up until its parent goes before it
+/// \param mh Pointer to the heap
+/// \param index Heap index
+static void minheap_sift_up(minheap_t *mh, int index) {
+    int id = mh->heap[index];
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!MINHEAP_BEFORE(mh, id, mh->heap[parent]))
+            break;
+        minheap_place(mh, index, mh->heap[parent]);
+        index = parent;
+    }
+    minheap_place(mh, index, id);
+}
+
+/// Moves the id at a heap index down until it goes before its children
+/// \param mh Pointer to the heap
+/// \param index Heap index
+static void minheap_sift_down(minheap_t *mh, int index) {
+    int id = mh->heap[index];
+    for (;;) {
+        int child = 2 * index + 1;
+        if (child >= mh->size)
+            break;
+        if (child + 1 < mh->size && MINHEAP_BEFORE(mh, mh->heap[child + 1], mh->heap[child]))
+            child++;
+        if (!MINHEAP_BEFORE(mh, mh->heap[child], id))
+            break;
+        minheap_place(mh, index, mh->heap[child]);
+        index = child;
+    }
+    minheap_place(mh, index, id);
+}
+
+int minheap_init(minheap_t *mh, int capacity) {
+    mh->size = 0;
+    mh->capacity = capacity;
+    mh->empty = 0;
+    mh->heap = malloc(sizeof(int) * capacity);
+    mh->location = malloc(sizeof(int) * capacity);
+    mh->counts = malloc(sizeof(int) * capacity);
+    mh->numbers = malloc(sizeof(long long) * capacity);
+    if (!mh->heap || !mh->location || !mh->counts || !mh->numbers) {
+        minheap_delete(mh);
+        return -1;
+    }
+    return 0;
+}
+
+void minheap_delete(minheap_t *mh) {
+    free(mh->heap);
+    free(mh->location);
+    free(mh->counts);
+    free(mh->numbers);
+}
+
+void minheap_push(minheap_t *mh, int id, int count, long long number) {
+    mh->counts[id] = count;
+    mh->numbers[id] = number;
+    mh->empty += !count;
+    mh->heap[mh->size] = id;
+    minheap_sift_up(mh, mh->size++);
+}
+
+void minheap_remove(minheap_t *mh, int id) {
+    int index = mh->location[id];
+    int last = mh->heap[--mh->size];
+    mh->empty -= !mh->counts[id];
+    if (last == id)
+        return;
+
+    /* The last id fills the hole and moves whichever way its key requires */
+    minheap_place(mh, index, last);
+    minheap_sift_up(mh, index);
+    minheap_sift_down(mh, mh->location[last]);
+}
+
+void minheap_decrease(minheap_t *mh, int id, int amount) {
+    if (!amount)
+        return;
+    mh->counts[id] -= amount;
+    mh->empty += !mh->counts[id];
+    minheap_sift_up(mh, mh->location[id]);
+}
@@ -0,0 +1,53 @@
+#ifndef MUMHORS_MINHEAP_H
+#define MUMHORS_MINHEAP_H
+
+/// Indexed min-heap over the rows of a window. Each row has a caller-assigned id (below the capacity), a count and
+/// a row number; the top is the row with the smallest count, ties going to the smallest row number (the first row
+/// in window order). It also keeps the number of rows whose count is 0, so finding the eviction candidate and
+/// detecting empty rows take no scan.
+typedef struct minheap {
+    int size;       /* Number of rows in the heap */
+    int capacity;   /* Maximum number of rows (ids are below it) */
+    int empty;      /* Number of rows whose count is 0 */
+    int *heap;      /* Ids in heap order */
+    int *location;  /* Heap index of each id */
+    int *counts;    /* Count of each id */
+    long long *numbers; /* Row number of each id */
+} minheap_t;
+
+/// Initializes an empty heap
+/// \param mh Pointer to the heap
+/// \param capacity Maximum number of rows
+/// \return 0, or -1 if the arrays cannot be allocated (none of them stays allocated)
+int minheap_init(minheap_t *mh, int capacity);
+
+/// Deletes the heap
+/// \param mh Pointer to the heap
+void minheap_delete(minheap_t *mh);
+
+/// Adds a row in O(log n)
+/// \param mh Pointer to the heap
+/// \param id Id of the row (not in the heap)
+/// \param count Count of the row
+/// \param number Row number
+void minheap_push(minheap_t *mh, int id, int count, long long number);
+
+/// Removes a row in O(log n)
+/// \param mh Pointer to the heap
+/// \param id Id of the row (in the heap)
+void minheap_remove(minheap_t *mh, int id);
+
+/// Subtracts an amount from the count of a row in O(log n)
+/// \param mh Pointer to the heap
+/// \param id Id of the row (in the heap)
+/// \param amount Amount to subtract (at most the count)
+void minheap_decrease(minheap_t *mh, int id, int amount);
+
+/// Returns the row with the smallest count (ties: smallest row number)
+/// \param mh Pointer to the heap (not empty)
+/// \return Id of the row
+static inline int minheap_top(const minheap_t *mh) {
+    return mh->heap[0];
+}
+
+#endif
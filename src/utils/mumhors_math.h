@@ -1,6 +1,11 @@
 #ifndef MUMHORS_MATH_H
 #define MUMHORS_MATH_H
 
+#include <stdint.h>
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
 
 /// Returns the minimum of two integers
 /// \param x First integer
@@ -8,16 +13,27 @@
 /// \return Minimum of two integers
 int min(int x, int y);
 
-/// Counts number of bits set in the given number
-/// \param num Given number
+/// Counts number of bits set in the given word (POPCNT when the target has it)
+/// \param word Given word
 /// \return Number of set bits
-int count_num_set_bits(int num);
+static inline int word_popcount(uint64_t word) {
+    return __builtin_popcountll(word);
+}
 
-/// Returns the bit index of the nth set bit of the given byte
-/// \param byte A given byte
-/// \param nth Nth set bit
-/// \return Bit index of the nth set bit of the given byte
-int byte_get_index_nth_set(unsigned char byte, int nth);
+/// Returns the bit index of the nth set bit of the given word. With BMI2 the nth set bit is isolated with PDEP
+/// and located with TZCNT, otherwise the lower set bits are cleared one at a time.
+/// \param word A given word
+/// \param nth Nth set bit (0-based, smaller than the number of set bits)
+/// \return Bit index (0 = least significant bit) of the nth set bit of the given word
+static inline int word_select(uint64_t word, int nth) {
+#ifdef __BMI2__
+    return (int) _tzcnt_u64(_pdep_u64(1ULL << nth, word));
+#else
+    for (int i = 0; i < nth; i++)
+        word &= word - 1;
+    return __builtin_ctzll(word);
+#endif
+}
 
 /// Computes the floor mod
 /// @param a First number
@@ -0,0 +1,44 @@
+#include "row_limit.h"
+
+
+void row_limit_init(row_limit_t *rl, int rows) {
+    rl->min = rows;
+    rl->max = rows;
+    rl->limit = rows;
+    rl->target = ROW_LIMIT_DEFAULT_TARGET;
+    rl->epoch = ROW_LIMIT_DEFAULT_EPOCH;
+    rl->epoch_rows = 0;
+    rl->epoch_discarded = 0;
+    rl->adjustments = 0;
+}
+
+void row_limit_set_adaptive(row_limit_t *rl, int min_rows, int target, int epoch) {
+    rl->min = min_rows;
+    rl->limit = rl->max;
+    rl->target = target;
+    rl->epoch = epoch;
+    rl->epoch_rows = 0;
+    rl->epoch_discarded = 0;
+}
+
+
+void row_limit_update(row_limit_t *rl, int added_rows, long long discarded_bits, int cols) {
+    if (rl->min == rl->max)
+        return;
+    rl->epoch_rows += added_rows;
+    rl->epoch_discarded += discarded_bits;
+    if (rl->epoch_rows < rl->epoch)
+        return;
+
+    /* Integer comparisons of the per mille rate, so every build takes the same decisions */
+    long long bits = (long long) rl->epoch_rows * cols * rl->target;
+    int limit = rl->limit;
+    if (rl->epoch_discarded * 1000 > bits && limit < rl->max)
+        limit++;
+    else if (rl->epoch_discarded * 2000 < bits && limit > rl->min)
+        limit--;
+    rl->adjustments += limit != rl->limit;
+    rl->limit = limit;
+    rl->epoch_rows = 0;
+    rl->epoch_discarded = 0;
+}
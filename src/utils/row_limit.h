@@ -0,0 +1,44 @@
+#ifndef MUMHORS_ROW_LIMIT_H
+#define MUMHORS_ROW_LIMIT_H
+
+/* Row limit: the number of rows the window may hold, between a minimum and the row threshold rt (the capacity of the
+ * window). A fixed limit is rt. An adaptive limit follows the discard rate: after every `epoch` rows that entered the
+ * window, it grows by one row if the evicted rows discarded more than `target` per mille of the bits of those rows
+ * (more rows leave the rows more time to empty), and shrinks by one row if they discarded less than half of it (fewer
+ * rows make the lookups cheaper). The rule only depends on the rows and the discarded bits, which the signer's bitmap
+ * and the verifier share, so the verifier replays every adjustment of the signer. */
+#define ROW_LIMIT_DEFAULT_TARGET 10 /* Per mille of the bits of the rows entering the window */
+#define ROW_LIMIT_DEFAULT_EPOCH 16  /* Rows entering the window between two adjustments */
+
+/// Row limit of a window
+typedef struct row_limit {
+    int min; /* Smallest limit */
+    int max; /* Largest limit (the row threshold) */
+    int limit; /* Current limit */
+    int target; /* Discard rate between which the limit shrinks (half of it) and grows, per mille */
+    int epoch; /* Rows entering the window between two adjustments */
+    int epoch_rows; /* Rows that entered the window in the current epoch */
+    long long epoch_discarded; /* Bits discarded in the current epoch */
+    int adjustments; /* Number of times the limit changed */
+} row_limit_t;
+
+/// Initializes a fixed row limit
+/// \param rl Pointer to the row limit
+/// \param rows The limit (the row threshold)
+void row_limit_init(row_limit_t *rl, int rows);
+
+/// Makes the row limit adaptive from its largest value (a minimum equal to the largest limit keeps it fixed)
+/// \param rl Pointer to the row limit
+/// \param min_rows Smallest limit (at least 1, at most the largest limit)
+/// \param target Discard rate target, per mille
+/// \param epoch Rows entering the window between two adjustments (at least 1)
+void row_limit_set_adaptive(row_limit_t *rl, int min_rows, int target, int epoch);
+
+/// Accounts an allocation of the window and adjusts the limit at the end of an epoch
+/// \param rl Pointer to the row limit
+/// \param added_rows Rows that entered the window
+/// \param discarded_bits Bits of the rows evicted to make room for them
+/// \param cols Number of columns of a row
+void row_limit_update(row_limit_t *rl, int added_rows, long long discarded_bits, int cols);
+
+#endif
@@ -0,0 +1,109 @@
+#include "row_threshold.h"
+#include <math.h>
+#include <stddef.h>
+
+/* Bisection steps of the solver (the bracket shrinks below 1e-20 of its width) */
+#define ROW_THRESHOLD_SOLVER_STEPS 64
+
+
+/// Evaluates the analytical equation of the row threshold (decreasing in rt, its root is the threshold)
+/// \param rt Row threshold (greater than 1)
+/// \param t HORS t parameter
+/// \param k HORS k parameter
+/// \param alpha Probability of the threshold
+/// \return t - k minus the keys a window of rt rows is expected to hold
+static double row_threshold_equation(double rt, int t, int k, double alpha) {
+    double used = (rt * t - t) / rt;
+    double spread = 2 * used * log2(rt) * (1 - (1 / alpha) * (log2(log2(rt)) / (2 * log2(rt))));
+    return t - k - (used + sqrt(spread > 0 ? spread : 0));
+}
+
+double row_threshold_solve(int t, int k, double alpha) {
+    if (k < 1 || k >= t)
+        return 0;
+
+    /* The equation is t - k > 0 next to 1 row, and negative from t / k + 1 rows, where the used keys alone are more
+     * than t - k */
+    double low = 1, high = (double) t / k + 1;
+    for (int step = 0; step < ROW_THRESHOLD_SOLVER_STEPS; step++) {
+        double middle = (low + high) / 2;
+        if (row_threshold_equation(middle, t, k, alpha) > 0)
+            low = middle;
+        else
+            high = middle;
+    }
+    return high;
+}
+
+int row_threshold_analytical(int t, int k, double alpha) {
+    double solution = row_threshold_solve(t, k, alpha);
+    return solution > 1 ? (int) ceil(solution) : 1;
+}
+
+
+int row_threshold_autotune(const simulation_config_t *config, int target, row_threshold_tuning_t *tuning) {
+    row_threshold_tuning_t local;
+    if (!tuning)
+        tuning = &local;
+    const int t = config->t, k = config->k;
+    tuning->solution = row_threshold_solve(t, k, ROW_THRESHOLD_DEFAULT_ALPHA);
+    tuning->analytical = row_threshold_analytical(t, k, ROW_THRESHOLD_DEFAULT_ALPHA);
+    if (tuning->analytical > config->r)
+        tuning->analytical = (int) config->r;
+    tuning->candidates = 0;
+    tuning->rt = 0;
+
+    /* The same rows for every candidate */
+    long long rows = ROW_THRESHOLD_TUNING_KEYS / t;
+    if (rows < (long long) ROW_THRESHOLD_TUNING_WINDOWS * tuning->analytical)
+        rows = (long long) ROW_THRESHOLD_TUNING_WINDOWS * tuning->analytical;
+    if (rows > config->r)
+        rows = config->r;
+
+    double fastest = 0;
+    for (int rt = 1; rt <= tuning->analytical && tuning->candidates < ROW_THRESHOLD_MAX_CANDIDATES; rt++) {
+        simulation_config_t candidate_config = *config;
+        simulation_result_t result;
+        candidate_config.r = rows;
+        candidate_config.rt = candidate_config.rt_min = rt;
+        candidate_config.max_signatures = 0;
+        row_threshold_candidate_t *candidate = &tuning->candidate[tuning->candidates++];
+        candidate->rt = rt;
+
+        /* The runs sign the same messages, only their times differ */
+        for (int run = 0; run < ROW_THRESHOLD_TIMING_RUNS; run++) {
+            simulation_run(&candidate_config, &result);
+            if (result.failed)
+                break;
+            double ns_per_signature = result.seconds * 1.0e9 / result.signatures;
+            if (!run || ns_per_signature < candidate->ns_per_signature)
+                candidate->ns_per_signature = ns_per_signature;
+        }
+
+        /* The windows of more rows cannot be allocated either */
+        if (result.failed) {
+            tuning->candidates--;
+            break;
+        }
+        candidate->discarded = 1000.0 * result.discarded_bits / ((double) rows * t);
+        candidate->key_usage = 1000.0 * result.signatures * k / ((double) rows * t);
+        if (!fastest || candidate->ns_per_signature < fastest)
+            fastest = candidate->ns_per_signature;
+    }
+
+    /* The costs need the fastest time, so they are compared once every candidate ran */
+    double least = 0;
+    for (int i = 0; i < tuning->candidates; i++) {
+        row_threshold_candidate_t *candidate = &tuning->candidate[i];
+        candidate->cost = (fastest > 0 ? candidate->ns_per_signature / fastest : 1) + candidate->discarded / target;
+        if (!i || candidate->cost < least)
+            least = candidate->cost;
+    }
+    for (int i = 0; i < tuning->candidates; i++) {
+        if (tuning->candidate[i].cost <= least + ROW_THRESHOLD_COST_TOLERANCE) {
+            tuning->rt = tuning->candidate[i].rt;
+            break;
+        }
+    }
+    return tuning->rt;
+}
@@ -0,0 +1,65 @@
+#ifndef MUMHORS_ROW_THRESHOLD_H
+#define MUMHORS_ROW_THRESHOLD_H
+
+#include "simulation.h"
+
+/* Row threshold (rt) selection. The analytical threshold is the root of the equation of
+ * Optimizations/row_threshold.m: the smallest number of rows whose window of t available keys keeps the k keys of a
+ * signature with probability alpha, so the window needs no eviction. The autotuner simulates the thresholds up to it
+ * on the bitmap (see simulation.h), with the eviction policy and extension run of the signer, and keeps the one of
+ * least cost: its time per signature over the fastest one, plus the share of the keys its evictions discard over a
+ * target share. Fewer rows make the select, the clear and the allocation cheaper, more rows discard fewer keys, and
+ * the cost weighs a discard of the target as much as a signature twice as slow as the fastest. The times are
+ * measured, so the threshold is tuned once and given to both the signer and the verifier; each time is the best of a
+ * few runs and costs within a tolerance go to the fewer rows, so the timing noise seldom changes the threshold. */
+#define ROW_THRESHOLD_DEFAULT_ALPHA 0.99 /* Probability of the analytical threshold */
+#define ROW_THRESHOLD_DEFAULT_TARGET 1 /* Discarded keys weighing as much as the time of the fastest, per mille */
+#define ROW_THRESHOLD_TUNING_KEYS (1L << 21) /* Keys simulated for each candidate (the rows are at most r) */
+#define ROW_THRESHOLD_TUNING_WINDOWS 16 /* Windows of the analytical threshold simulated at least */
+#define ROW_THRESHOLD_MAX_CANDIDATES 64 /* Candidates of a tuning (the largest thresholds are not simulated) */
+#define ROW_THRESHOLD_TIMING_RUNS 3 /* Simulations of a candidate, the fastest one gives its time */
+#define ROW_THRESHOLD_COST_TOLERANCE 0.1 /* Cost above the least one that still prefers fewer rows */
+
+/// A simulated threshold
+typedef struct row_threshold_candidate {
+    int rt; /* Row threshold */
+    double discarded; /* Discarded keys, per mille of the simulated keys */
+    double key_usage; /* Keys that signed a message, per mille of the simulated keys */
+    double ns_per_signature; /* Time of a simulated signature (bitmap only, the best of the timing runs) */
+    double cost; /* Time over the fastest candidate's, plus the discarded keys over the target */
+} row_threshold_candidate_t;
+
+/// Outcome of a tuning
+typedef struct row_threshold_tuning {
+    double solution; /* Root of the analytical equation (0 if it has none) */
+    int analytical; /* Analytical threshold (the root rounded up, at most r) */
+    int rt; /* Chosen threshold (0 if no candidate could be allocated) */
+    int candidates; /* Number of simulated thresholds (the tuning stops at the first one whose bitmap fails) */
+    row_threshold_candidate_t candidate[ROW_THRESHOLD_MAX_CANDIDATES]; /* Simulated thresholds, from 1 row */
+} row_threshold_tuning_t;
+
+/// Solves the analytical equation of the row threshold
+/// \param t HORS t parameter
+/// \param k HORS k parameter
+/// \param alpha Probability that a window of t available keys keeps the k keys of a signature (0 < alpha < 1)
+/// \return Real root (greater than 1) or 0 if the equation has none (k is not smaller than t)
+double row_threshold_solve(int t, int k, double alpha);
+
+/// Returns the analytical row threshold
+/// \param t HORS t parameter
+/// \param k HORS k parameter
+/// \param alpha Probability that a window of t available keys keeps the k keys of a signature
+/// \return The root of the equation rounded up (1 if it has none)
+int row_threshold_analytical(int t, int k, double alpha);
+
+/// Tunes the row threshold of a key matrix by simulating the thresholds from 1 row up to the analytical one (with the
+/// default alpha) and keeping the one of least cost
+/// \param config Key matrix to tune for: t, k, r, the engine, the eviction policy and the extension run (the row
+/// threshold and the row limit are replaced by a fixed limit of each candidate)
+/// \param target Discarded keys weighing as much as the time of the fastest candidate, per mille (at least 1)
+/// \param tuning Pointer to the outcome which will be filled (NULL if not needed)
+/// \return Row threshold of least cost (the fewest rows within ROW_THRESHOLD_COST_TOLERANCE of it), 0 if not even
+/// the bitmap of one row could be allocated
+int row_threshold_autotune(const simulation_config_t *config, int target, row_threshold_tuning_t *tuning);
+
+#endif
@@ -0,0 +1,136 @@
+#include "simulation.h"
+#include <pthread.h>
+#include <string.h>
+#include <sys/time.h>
+
+
+void simulation_config_init(simulation_config_t *config, int t, int k, long long r, int rt) {
+    config->engine = NULL;
+    config->t = t;
+    config->k = k;
+    config->r = r;
+    config->rt = rt;
+    config->rt_min = rt;
+    config->row_limit_target = ROW_LIMIT_DEFAULT_TARGET;
+    config->row_limit_epoch = ROW_LIMIT_DEFAULT_EPOCH;
+    config->eviction_policy = EVICTION_FEWEST;
+    config->eviction_param = 0;
+    config->run = 1;
+    config->max_signatures = 0;
+    config->seed = SIMULATION_DEFAULT_SEED;
+}
+
+
+uint64_t simulation_random(uint64_t *state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1DULL;
+}
+
+void simulation_draw_indices(uint64_t *state, int window_size, int k, int *indices, int *sorted_indices) {
+    /* Each index is inserted into the descending order as it is drawn, which also finds the repeated ones */
+    for (int i = 0; i < k;) {
+        int index = (int) (simulation_random(state) % window_size);
+        int position = i;
+        while (position > 0 && sorted_indices[position - 1] < index)
+            position--;
+        if (position > 0 && sorted_indices[position - 1] == index)
+            continue;
+        memmove(sorted_indices + position + 1, sorted_indices + position, sizeof(int) * (i - position));
+        sorted_indices[position] = index;
+        indices[i++] = index;
+    }
+}
+
+
+void simulation_run(const simulation_config_t *config, simulation_result_t *result) {
+    const int k = config->k;
+    bitmap_t bm;
+    memset(result, 0, sizeof(*result));
+    if (bitmap_init(&bm, config->engine, config->r, config->t, config->rt, config->t) != BITMAP_INIT_SUCCESS) {
+        result->failed = 1;
+        return;
+    }
+    bitmap_set_eviction(&bm, config->eviction_policy, config->eviction_param);
+    bitmap_set_row_limit(&bm, config->rt_min, config->row_limit_target, config->row_limit_epoch);
+    bitmap_set_headroom(&bm, (config->run - 1) * k);
+
+    int indices[k], sorted_indices[k], cols[k];
+    long long rows[k];
+    uint64_t state = config->seed;
+    struct timeval start_time, end_time;
+
+    gettimeofday(&start_time, NULL);
+    int status;
+    do {
+        simulation_draw_indices(&state, config->t, k, indices, sorted_indices);
+        bitmap_select_and_clear(&bm, indices, sorted_indices, k, rows, cols);
+        result->active_rows += bm.active_rows;
+        result->signatures++;
+        long long nxt_row_number = bm.nxt_row_number;
+        status = bitmap_extend_matrix(&bm);
+        result->extensions += bm.nxt_row_number != nxt_row_number;
+    } while (status == BITMAP_EXTENSION_SUCCESS && result->signatures != config->max_signatures);
+    gettimeofday(&end_time, NULL);
+
+    result->used_rows = bm.nxt_row_number;
+    result->discarded_bits = bm.discarded_bits;
+    result->discarded_rows = bm.discarded_rows;
+    result->row_limit = bm.row_limit.limit;
+    result->row_limit_adjustments = bm.row_limit.adjustments;
+    result->exhausted = status == BITMAP_EXTENSION_FAILED;
+    result->seconds = (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_usec - start_time.tv_usec) / 1.0e6;
+    bitmap_delete(&bm);
+}
+
+
+/// Trials of one thread: the trials whose number is the thread id modulo the number of threads
+typedef struct simulation_job {
+    const simulation_config_t *config;
+    simulation_result_t *results;
+    int trials;
+    int id;
+    int threads;
+} simulation_job_t;
+
+/// Runs the trials of a job
+/// \param arg Pointer to the job
+/// \return NULL
+static void *simulation_worker(void *arg) {
+    const simulation_job_t *job = arg;
+    for (int trial = job->id; trial < job->trials; trial += job->threads) {
+        /* The seed of a trial is the seed of the configuration through a SplitMix64 step */
+        simulation_config_t config = *job->config;
+        if (trial) {
+            uint64_t seed = config.seed + (uint64_t) trial * 0x9E3779B97F4A7C15ULL;
+            seed = (seed ^ seed >> 30) * 0xBF58476D1CE4E5B9ULL;
+            seed = (seed ^ seed >> 27) * 0x94D049BB133111EBULL;
+            config.seed = (seed ^ seed >> 31) | 1;
+        }
+        simulation_run(&config, &job->results[trial]);
+    }
+    return NULL;
+}
+
+void simulation_run_trials(const simulation_config_t *config, int trials, int threads, simulation_result_t *results) {
+    if (threads > trials)
+        threads = trials;
+    if (threads < 1)
+        threads = 1;
+
+    simulation_job_t jobs[threads];
+    pthread_t workers[threads];
+    int started[threads];
+    for (int i = 0; i < threads; i++) {
+        jobs[i] = (simulation_job_t) {config, results, trials, i, threads};
+        /* A job whose thread cannot be started runs on the calling thread */
+        started[i] = i && pthread_create(&workers[i], NULL, simulation_worker, &jobs[i]) == 0;
+    }
+    for (int i = 0; i < threads; i++)
+        if (!started[i])
+            simulation_worker(&jobs[i]);
+    for (int i = 1; i < threads; i++)
+        if (started[i])
+            pthread_join(workers[i], NULL);
+}
@@ -0,0 +1,79 @@
+#ifndef MUMHORS_SIMULATION_H
+#define MUMHORS_SIMULATION_H
+
+#include <stdint.h>
+#include "bitmap.h"
+
+/* Bitmap-only simulation: signatures whose k distinct indices come from a PRNG instead of the message digest, signed
+ * by the production bitmap (select, clear, extension, eviction and row limit) without any hashing. It gives the key
+ * usage, the evictions and the signatures to exhaustion of a key matrix, for sizing t, k, r and rt. */
+#define SIMULATION_DEFAULT_SEED 0x9E3779B97F4A7C15ULL
+
+/// Parameters of a simulation
+typedef struct simulation_config {
+    const bitmap_engine_t *engine; /* Engine of the bitmap (NULL for BITMAP_DEFAULT_ENGINE) */
+    int t; /* HORS t parameter (columns and window size) */
+    int k; /* HORS k parameter (indices per signature) */
+    long long r; /* Number of rows */
+    int rt; /* Row threshold */
+    int rt_min; /* Smallest row limit (rt for a fixed limit) */
+    int row_limit_target; /* Discard rate target of an adaptive row limit, per mille */
+    int row_limit_epoch; /* Rows entering the window between two adjustments of an adaptive row limit */
+    int eviction_policy; /* Eviction policy (EVICTION_*) */
+    int eviction_param; /* Parameter of the eviction policy */
+    int run; /* Signatures served by one extension (see bitmap_set_headroom) */
+    long long max_signatures; /* Signatures after which the simulation stops (0 to sign until the rows run out) */
+    uint64_t seed; /* Seed of the indices (non-zero) */
+} simulation_config_t;
+
+/// Outcome of a simulation
+typedef struct simulation_result {
+    long long signatures; /* Signed messages */
+    long long extensions; /* Extensions that allocated rows */
+    long long used_rows; /* Rows that entered the window */
+    long long discarded_bits; /* Set bits of the evicted rows */
+    long long discarded_rows; /* Evicted rows */
+    long long active_rows; /* Sum over the signatures of the active rows they selected from */
+    int row_limit; /* Row limit at the end */
+    int row_limit_adjustments; /* Number of times the row limit changed */
+    int exhausted; /* Whether the rows ran out (otherwise max_signatures was reached) */
+    int failed; /* Whether the bitmap could not be allocated (nothing was signed, the other fields are 0) */
+    double seconds; /* Time of the simulation */
+} simulation_result_t;
+
+/// Initializes a configuration with a fixed row limit (and the default adaptive parameters), the default eviction
+/// policy, runs of one signature, no signature limit and the default seed
+/// \param config Pointer to the configuration
+/// \param t HORS t parameter
+/// \param k HORS k parameter
+/// \param r Number of rows
+/// \param rt Row threshold
+void simulation_config_init(simulation_config_t *config, int t, int k, long long r, int rt);
+
+/// Xorshift64* generator
+/// \param state Pointer to the generator state (non-zero)
+/// \return Next random number
+uint64_t simulation_random(uint64_t *state);
+
+/// Draws k distinct indices below the window size (a redrawn index replaces a repeated one)
+/// \param state Pointer to the generator state
+/// \param window_size Number of available indices
+/// \param k Number of indices (at most window_size)
+/// \param indices Array for the indices in message order
+/// \param sorted_indices Array for the indices in descending order
+void simulation_draw_indices(uint64_t *state, int window_size, int k, int *indices, int *sorted_indices);
+
+/// Signs random messages with a bitmap until its rows run out or max_signatures is reached
+/// \param config Pointer to the configuration
+/// \param result Pointer to the result which will be filled (failed is set if bitmap_init failed)
+void simulation_run(const simulation_config_t *config, simulation_result_t *result);
+
+/// Runs independent simulations of a configuration (trial i draws its indices from a seed derived from the seed of
+/// the configuration and i; trial 0 uses the seed itself) on a pool of threads
+/// \param config Pointer to the configuration
+/// \param trials Number of trials
+/// \param threads Number of threads (at least 1)
+/// \param results Array which will store the result of each trial
+void simulation_run_trials(const simulation_config_t *config, int trials, int threads, simulation_result_t *results);
+
+#endif
@@ -0,0 +1,586 @@
+#include "hash.h"
+#include "bitmap.h"
+#include "simulation.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+
+/// Returns the elapsed time between two time points
+/// \param start Start time
+/// \param end End time
+/// \return Elapsed time in seconds
+static double elapsed_seconds(const struct timeval *start, const struct timeval *end) {
+    return (end->tv_sec - start->tv_sec) + (end->tv_usec - start->tv_usec) / 1.0e6;
+}
+
+/// Initializes a bitmap of a suite (a window of t-bit rows), reporting an allocation failure
+/// \param bm Pointer to the bitmap structure
+/// \param engine Bitmap engine (NULL for BITMAP_DEFAULT_ENGINE)
+/// \param r Number of rows
+/// \param t Number of columns
+/// \param rt Row threshold
+/// \return 1 if it was initialized
+static int bench_bitmap_init(bitmap_t *bm, const bitmap_engine_t *engine, long long r, int t, int rt) {
+    if (bitmap_init(bm, engine, r, t, rt, t) == BITMAP_INIT_SUCCESS)
+        return 1;
+    printf("Cannot allocate a %s bitmap of %d rows of %d columns\n", (engine ? engine : BITMAP_DEFAULT_ENGINE)->name,
+           rt, t);
+    return 0;
+}
+
+
+/*
+ *
+ *  Digest suite: throughput of the message digest candidates from 4 KB to MAX_SIZE
+ *
+ */
+#define DIGEST_MIN_SIZE (4L << 10)
+#define DIGEST_DEFAULT_MAX_SIZE (1L << 30)
+#define DIGEST_BYTES_PER_POINT (256L << 20) /* Bytes hashed per size and digest (at least one message) */
+
+/// Hashes the input with one of the digest candidates
+/// \param digest Candidate number (blake2b, blake2bp, tree16, tree16 on several threads)
+/// \param hash_output Pointer to buffer that the hash will be stored
+/// \param input Pointer to the input that we want the hash value
+/// \param length The length of the input
+/// \param threads Number of threads of the multi-threaded candidate
+/// \return The size of the hash
+static int digest_candidate(int digest, unsigned char *hash_output, const unsigned char *input, long length,
+                            int threads) {
+    switch (digest) {
+        case 0:
+            return blake2b_256(hash_output, input, length);
+        case 1:
+            return blake2b_tree_256(hash_output, input, length, 4, 1);
+        case 2:
+            return blake2b_tree_256(hash_output, input, length, 16, 1);
+        default:
+            return blake2b_tree_256(hash_output, input, length, 16, threads);
+    }
+}
+
+static int bench_digest(int argc, char **argv) {
+    long max_size = argc > 0 ? atol(argv[0]) : DIGEST_DEFAULT_MAX_SIZE;
+    int threads = argc > 1 ? atoi(argv[1]) : 4;
+    const char *digest_names[] = {"blake2b", "blake2bp", "tree16", "tree16-mt"};
+
+    unsigned char *message = malloc(max_size);
+    if (!message) {
+        printf("Cannot allocate %ld bytes\n", max_size);
+        return 1;
+    }
+    for (long i = 0; i < max_size; i++)
+        message[i] = (unsigned char) (i * 131 + (i >> 12));
+
+    printf("================ Digest throughput (GB/s, %d threads for tree16-mt) ================\n", threads);
+    printf("%12s", "size");
+    for (int digest = 0; digest < 4; digest++)
+        printf("%12s", digest_names[digest]);
+    printf("\n");
+
+    for (long size = DIGEST_MIN_SIZE; size <= max_size; size *= 4) {
+        printf("%12ld", size);
+        long iterations = DIGEST_BYTES_PER_POINT / size > 0 ? DIGEST_BYTES_PER_POINT / size : 1;
+        for (int digest = 0; digest < 4; digest++) {
+            unsigned char hash[SHA256_OUTPUT_LEN];
+            struct timeval start_time, end_time;
+            gettimeofday(&start_time, NULL);
+            for (long i = 0; i < iterations; i++) {
+                /* Chain the iterations so none of them can be skipped */
+                message[0] ^= (unsigned char) i;
+                digest_candidate(digest, hash, message, size, threads);
+                message[1] ^= hash[0];
+            }
+            gettimeofday(&end_time, NULL);
+            printf("%12.3f", (double) size * iterations / elapsed_seconds(&start_time, &end_time) / 1.0e9);
+            fflush(stdout);
+        }
+        printf("\n");
+    }
+
+    free(message);
+    return 0;
+}
+
+
+/*
+ *
+ *  Batch suite: k lookups plus one unset pass against the batched select-and-clear, on the same index sequence, for
+ *  every bitmap engine
+ *
+ */
+static int bench_batch(int argc, char **argv) {
+    if (argc < 4) {
+        printf("mumhors_bench batch T K RT SIGNATURES\n");
+        return 1;
+    }
+    const int t = atoi(argv[0]);
+    const int k = atoi(argv[1]);
+    const int rt = atoi(argv[2]);
+    const int signatures = atoi(argv[3]);
+    const long long r = rt + (long long) signatures * k * 2 / t + 1;
+
+    /* A bitmap per engine for each way of signing; all of them see the same indices */
+    bitmap_t separate_bms[BITMAP_NUM_ENGINES], batch_bms[BITMAP_NUM_ENGINES];
+    for (int e = 0; e < BITMAP_NUM_ENGINES; e++) {
+        if (!bench_bitmap_init(&separate_bms[e], bitmap_engines[e], r, t, rt) ||
+            !bench_bitmap_init(&batch_bms[e], bitmap_engines[e], r, t, rt))
+            return 1;
+    }
+
+    int indices[k], sorted_indices[k], separate_cols[k], batch_cols[k], reference_cols[k];
+    long long separate_rows[k], batch_rows[k], reference_rows[k];
+    uint64_t state = SIMULATION_DEFAULT_SEED;
+    double separate_time[BITMAP_NUM_ENGINES] = {0}, batch_time[BITMAP_NUM_ENGINES] = {0};
+    int mismatches[BITMAP_NUM_ENGINES] = {0};
+    int done = 0, failed = 0;
+    struct timeval start_time, end_time;
+
+    for (; done < signatures && !failed; done++) {
+        simulation_draw_indices(&state, t, k, indices, sorted_indices);
+
+        for (int e = 0; e < BITMAP_NUM_ENGINES; e++) {
+            /* The signer up to now: one lookup per index, then one unset pass */
+            gettimeofday(&start_time, NULL);
+            for (int i = 0; i < k; i++)
+                bitmap_get_row_colum_with_index(&separate_bms[e], indices[i], &separate_rows[i], &separate_cols[i]);
+            bitmap_unset_indices_in_window(&separate_bms[e], sorted_indices, k);
+            gettimeofday(&end_time, NULL);
+            separate_time[e] += elapsed_seconds(&start_time, &end_time);
+
+            gettimeofday(&start_time, NULL);
+            bitmap_select_and_clear(&batch_bms[e], indices, sorted_indices, k, batch_rows, batch_cols);
+            gettimeofday(&end_time, NULL);
+            batch_time[e] += elapsed_seconds(&start_time, &end_time);
+
+            /* The separate calls of the first engine are the reference */
+            if (e == 0) {
+                memcpy(reference_rows, separate_rows, sizeof(reference_rows));
+                memcpy(reference_cols, separate_cols, sizeof(reference_cols));
+            }
+            for (int i = 0; i < k; i++) {
+                mismatches[e] += separate_rows[i] != reference_rows[i] || separate_cols[i] != reference_cols[i];
+                mismatches[e] += batch_rows[i] != reference_rows[i] || batch_cols[i] != reference_cols[i];
+            }
+
+            if (bitmap_extend_matrix(&separate_bms[e]) == BITMAP_EXTENSION_FAILED ||
+                bitmap_extend_matrix(&batch_bms[e]) == BITMAP_EXTENSION_FAILED)
+                failed = 1;
+        }
+    }
+
+    printf("================ Select and clear (t=%d k=%d rt=%d, %d signatures) ================\n", t, k, rt, done);
+    printf("%-8s %24s %16s %10s %12s\n", "Engine", "k lookups + unset (ns)", "Batched (ns)", "Speedup",
+           "Mismatches");
+    int total_mismatches = 0;
+    for (int e = 0; e < BITMAP_NUM_ENGINES; e++) {
+        printf("%-8s %24.3f %16.3f %9.2fx %12d\n", bitmap_engines[e]->name, separate_time[e] * 1.0e9 / done,
+               batch_time[e] * 1.0e9 / done, separate_time[e] / batch_time[e], mismatches[e]);
+        total_mismatches += mismatches[e];
+        bitmap_delete(&separate_bms[e]);
+        bitmap_delete(&batch_bms[e]);
+    }
+    printf("Mismatches count the (row, col) pairs that differ from the k lookups of the %s engine\n",
+           bitmap_engines[0]->name);
+    return total_mismatches ? 1 : 0;
+}
+
+
+/*
+ *
+ *  Columns suite: batched select-and-clear of every bitmap engine as t doubles from T_MIN to T_MAX, with the bytes of
+ *  a row in each engine
+ *
+ */
+#define COLUMNS_DEFAULT_MIN_T (1 << 10)
+#define COLUMNS_DEFAULT_MAX_T (1 << 20)
+
+/// Returns the bytes taken by a row of a bitmap (its words and its index)
+/// \param bm Pointer to the bitmap structure
+/// \return Bytes from one row buffer or chunk to the next
+static int bench_row_bytes(const bitmap_t *bm) {
+    if (bm->engine == &bitmap_list_engine)
+        return bm->bitmap_matrix.list.stride;
+    return bm->bitmap_matrix.array.stride;
+}
+
+static int bench_columns(int argc, char **argv) {
+    if (argc < 3) {
+        printf("mumhors_bench columns K RT SIGNATURES [T_MIN] [T_MAX]\n");
+        return 1;
+    }
+    const int k = atoi(argv[0]);
+    const int rt = atoi(argv[1]);
+    const int signatures = atoi(argv[2]);
+    const int min_t = argc > 3 ? atoi(argv[3]) : COLUMNS_DEFAULT_MIN_T;
+    const int max_t = argc > 4 ? atoi(argv[4]) : COLUMNS_DEFAULT_MAX_T;
+    if (min_t < 64 || min_t % 8 || k >= min_t) {
+        printf("Invalid parameters\n");
+        return 1;
+    }
+
+    printf("================ Select and clear across t (k=%d rt=%d, %d signatures) ================\n", k, rt,
+           signatures);
+    printf("%-9s", "t");
+    for (int e = 0; e < BITMAP_NUM_ENGINES; e++)
+        printf(" %12s (ns) %10s", bitmap_engines[e]->name, "Row bytes");
+    printf(" %12s\n", "Mismatches");
+
+    int total_mismatches = 0;
+    for (int t = min_t; t <= max_t; t *= 2) {
+        const long long r = rt + (long long) signatures * k * 2 / t + 1;
+        bitmap_t bms[BITMAP_NUM_ENGINES];
+        for (int e = 0; e < BITMAP_NUM_ENGINES; e++) {
+            if (!bench_bitmap_init(&bms[e], bitmap_engines[e], r, t, rt))
+                return 1;
+        }
+
+        int indices[k], sorted_indices[k], cols[k], reference_cols[k];
+        long long rows[k], reference_rows[k];
+        uint64_t state = SIMULATION_DEFAULT_SEED;
+        double batch_time[BITMAP_NUM_ENGINES] = {0};
+        int mismatches = 0, done = 0, failed = 0;
+        struct timeval start_time, end_time;
+
+        for (; done < signatures && !failed; done++) {
+            simulation_draw_indices(&state, t, k, indices, sorted_indices);
+            for (int e = 0; e < BITMAP_NUM_ENGINES; e++) {
+                gettimeofday(&start_time, NULL);
+                bitmap_select_and_clear(&bms[e], indices, sorted_indices, k, rows, cols);
+                gettimeofday(&end_time, NULL);
+                batch_time[e] += elapsed_seconds(&start_time, &end_time);
+
+                /* The first engine is the reference */
+                if (e == 0) {
+                    memcpy(reference_rows, rows, sizeof(reference_rows));
+                    memcpy(reference_cols, cols, sizeof(reference_cols));
+                }
+                for (int i = 0; i < k; i++)
+                    mismatches += rows[i] != reference_rows[i] || cols[i] != reference_cols[i];
+                if (bitmap_extend_matrix(&bms[e]) == BITMAP_EXTENSION_FAILED)
+                    failed = 1;
+            }
+        }
+
+        printf("%-9d", t);
+        for (int e = 0; e < BITMAP_NUM_ENGINES; e++) {
+            printf(" %17.3f %10d", batch_time[e] * 1.0e9 / done, bench_row_bytes(&bms[e]));
+            bitmap_delete(&bms[e]);
+        }
+        printf(" %12d\n", mismatches);
+        total_mismatches += mismatches;
+    }
+    printf("Times are per signature (k selects and clears); mismatches count the (row, col) pairs that differ from "
+           "the %s engine\n", bitmap_engines[0]->name);
+    return total_mismatches ? 1 : 0;
+}
+
+/*
+ *
+ *  Snapshot suite: size of the bitmap snapshots and time to write and restore them along a run of signatures, and
+ *  whether the restored bitmaps (in every engine) keep signing like the original one
+ *
+ */
+#define SNAPSHOT_REPETITIONS 200 /* Snapshots and restores timed at each checkpoint */
+#define SNAPSHOT_CHECK_SIGNATURES 256 /* Signatures compared after a restore */
+
+static int bench_snapshot(int argc, char **argv) {
+    if (argc < 4) {
+        printf("mumhors_bench snapshot T K RT SIGNATURES [CHECKPOINTS]\n");
+        return 1;
+    }
+    const int t = atoi(argv[0]);
+    const int k = atoi(argv[1]);
+    const int rt = atoi(argv[2]);
+    const int signatures = atoi(argv[3]);
+    const int checkpoints = argc > 4 ? atoi(argv[4]) : 4;
+    const long long r = rt + (long long) (signatures + checkpoints * SNAPSHOT_CHECK_SIGNATURES) * k * 2 / t + 1;
+
+    bitmap_t bm;
+    if (!bench_bitmap_init(&bm, NULL, r, t, rt))
+        return 1;
+    unsigned char *snapshot = malloc(bitmap_snapshot_size_bound(&bm));
+
+    int indices[k], sorted_indices[k], cols[k], restored_cols[k];
+    long long rows[k], restored_rows[k];
+    uint64_t state = SIMULATION_DEFAULT_SEED;
+    int mismatches = 0, done = 0;
+    struct timeval start_time, end_time;
+
+    printf("================ Bitmap snapshots (t=%d k=%d rt=%d, %s engine) ================\n", t, k, rt,
+           bm.engine->name);
+    printf("%10s %6s %10s %10s %14s", "Signatures", "Rows", "Bytes", "Raw bytes", "Snapshot (us)");
+    for (int e = 0; e < BITMAP_NUM_ENGINES; e++)
+        printf(" %9s (us)", bitmap_engines[e]->name);
+    printf(" %10s\n", "Mismatches");
+
+    for (int checkpoint = 1; checkpoint <= checkpoints; checkpoint++) {
+        /* Sign up to the checkpoint */
+        for (; done < (long) signatures * checkpoint / checkpoints; done++) {
+            simulation_draw_indices(&state, t, k, indices, sorted_indices);
+            bitmap_select_and_clear(&bm, indices, sorted_indices, k, rows, cols);
+            bitmap_extend_matrix(&bm);
+        }
+
+        size_t length = 0;
+        gettimeofday(&start_time, NULL);
+        for (int i = 0; i < SNAPSHOT_REPETITIONS; i++)
+            length = bitmap_snapshot(&bm, snapshot);
+        gettimeofday(&end_time, NULL);
+        printf("%10d %6d %10zu %10d %14.3f", done, bm.active_rows, length, bm.active_rows * t / 8,
+               elapsed_seconds(&start_time, &end_time) * 1.0e6 / SNAPSHOT_REPETITIONS);
+
+        /* Restore in every engine, then sign the same messages with the restored bitmaps and the original one */
+        bitmap_t restored[BITMAP_NUM_ENGINES];
+        for (int e = 0; e < BITMAP_NUM_ENGINES; e++) {
+            gettimeofday(&start_time, NULL);
+            for (int i = 0; i < SNAPSHOT_REPETITIONS; i++) {
+                if (i)
+                    bitmap_delete(&restored[e]);
+                if (bitmap_restore(&restored[e], bitmap_engines[e], snapshot, length) != BITMAP_RESTORE_SUCCESS) {
+                    printf("\nRestoring the snapshot in the %s engine failed\n", bitmap_engines[e]->name);
+                    return 1;
+                }
+            }
+            gettimeofday(&end_time, NULL);
+            printf(" %14.3f", elapsed_seconds(&start_time, &end_time) * 1.0e6 / SNAPSHOT_REPETITIONS);
+        }
+        int checkpoint_mismatches = 0;
+        for (int i = 0; i < SNAPSHOT_CHECK_SIGNATURES; i++) {
+            simulation_draw_indices(&state, t, k, indices, sorted_indices);
+            bitmap_select_and_clear(&bm, indices, sorted_indices, k, rows, cols);
+            bitmap_extend_matrix(&bm);
+            for (int e = 0; e < BITMAP_NUM_ENGINES; e++) {
+                bitmap_select_and_clear(&restored[e], indices, sorted_indices, k, restored_rows, restored_cols);
+                bitmap_extend_matrix(&restored[e]);
+                for (int j = 0; j < k; j++)
+                    checkpoint_mismatches += rows[j] != restored_rows[j] || cols[j] != restored_cols[j];
+            }
+        }
+        for (int e = 0; e < BITMAP_NUM_ENGINES; e++)
+            bitmap_delete(&restored[e]);
+        printf(" %10d\n", checkpoint_mismatches);
+        mismatches += checkpoint_mismatches;
+    }
+    printf("Mismatches count the (row, col) pairs of the next %d signatures that differ from the original bitmap\n",
+           SNAPSHOT_CHECK_SIGNATURES);
+
+    free(snapshot);
+    bitmap_delete(&bm);
+    return mismatches ? 1 : 0;
+}
+
+
+/*
+ *
+ *  Eviction suite: signatures and discarded bits per key matrix (until its rows run out) for each eviction policy
+ *
+ */
+static int bench_eviction(int argc, char **argv) {
+    if (argc < 4) {
+        printf("mumhors_bench eviction T K RT R [POLICY[:PARAM] ...]\n");
+        return 1;
+    }
+    const int t = atoi(argv[0]);
+    const int k = atoi(argv[1]);
+    const int rt = atoi(argv[2]);
+    const long long r = atoll(argv[3]);
+
+    /* The policies on the command line, or each policy with a few parameters */
+    char default_policies[6][32];
+    snprintf(default_policies[0], 32, "fewest");
+    snprintf(default_policies[1], 32, "oldest");
+    snprintf(default_policies[2], 32, "below:%d", t / 32);
+    snprintf(default_policies[3], 32, "below:%d", t / 8);
+    snprintf(default_policies[4], 32, "batch:2");
+    snprintf(default_policies[5], 32, "batch:4");
+    int num_policies = argc > 4 ? argc - 4 : 6;
+
+    printf("================ Eviction policies (t=%d k=%d rt=%d r=%lld) ================\n", t, k, rt, r);
+    printf("%-12s %12s %12s %16s %12s %14s\n", "Policy", "Signatures", "Evicted rows", "Discarded bits",
+           "Key usage", "ns/signature");
+
+    for (int p = 0; p < num_policies; p++) {
+        /* The name is split from its parameter in place, so it is copied whole or rejected */
+        const char *argument = argc > 4 ? argv[4 + p] : default_policies[p];
+        char name[32];
+        if (strlen(argument) >= sizeof(name)) {
+            printf("Eviction policy too long: %s\n", argument);
+            return 1;
+        }
+        memcpy(name, argument, strlen(argument) + 1);
+        char *param = strchr(name, ':');
+        if (param)
+            *param++ = '\0';
+        int policy = eviction_policy_find(name);
+        if (policy < 0) {
+            printf("Unknown eviction policy: %s\n", name);
+            return 1;
+        }
+
+        /* The same messages for every policy */
+        simulation_config_t config;
+        simulation_result_t result;
+        simulation_config_init(&config, t, k, r, rt);
+        config.eviction_policy = policy;
+        config.eviction_param = param ? atoi(param) : 0;
+        simulation_run(&config, &result);
+        if (result.failed) {
+            printf("Cannot allocate a bitmap of %d rows of %d columns\n", rt, t);
+            return 1;
+        }
+
+        char label[40];
+        snprintf(label, sizeof(label), param ? "%s:%s" : "%s", name, param);
+        printf("%-12s %12lld %12lld %16lld %11.2f%% %14.1f\n", label, result.signatures, result.discarded_rows,
+               result.discarded_bits, 100.0 * result.signatures * k / ((double) r * t),
+               result.seconds * 1.0e9 / result.signatures);
+    }
+    printf("Key usage is the share of the r * t private keys that signed a message\n");
+    return 0;
+}
+
+
+/// Signs random index sets with a bitmap until its rows run out and prints one line of the row limit suite
+/// \param label Label of the configuration
+/// \param t HORS t parameter
+/// \param k HORS k parameter
+/// \param r Number of rows
+/// \param rt Row threshold (largest limit)
+/// \param min_rows Smallest limit (rt for a fixed limit)
+/// \param target Discard rate target, per mille
+/// \param epoch Rows entering the window between two adjustments
+/// \return 1 if the bitmap was allocated
+static int bench_row_limit_run(const char *label, int t, int k, long long r, int rt, int min_rows, int target,
+                               int epoch) {
+    simulation_config_t config;
+    simulation_result_t result;
+    simulation_config_init(&config, t, k, r, rt);
+    config.rt_min = min_rows;
+    config.row_limit_target = target;
+    config.row_limit_epoch = epoch;
+    simulation_run(&config, &result);
+    if (result.failed) {
+        printf("Cannot allocate a bitmap of %d rows of %d columns\n", rt, t);
+        return 0;
+    }
+
+    printf("%-14s %12lld %11.2f%% %12.2f %10d %12d %14.1f\n", label, result.signatures,
+           100.0 * result.signatures * k / ((double) r * t), (double) result.active_rows / result.signatures,
+           result.row_limit, result.row_limit_adjustments, result.seconds * 1.0e9 / result.signatures);
+    return 1;
+}
+
+/*
+ *
+ *  Row limit suite: key usage and lookup cost of fixed row thresholds against an adaptive row limit
+ *
+ */
+static int bench_row_limit(int argc, char **argv) {
+    if (argc < 5) {
+        printf("mumhors_bench rowlimit T K R MIN MAX [TARGET] [EPOCH]\n");
+        return 1;
+    }
+    const int t = atoi(argv[0]);
+    const int k = atoi(argv[1]);
+    const long long r = atoll(argv[2]);
+    const int min_rows = atoi(argv[3]);
+    const int max_rows = atoi(argv[4]);
+    const int target = argc > 5 ? atoi(argv[5]) : ROW_LIMIT_DEFAULT_TARGET;
+    const int epoch = argc > 6 ? atoi(argv[6]) : ROW_LIMIT_DEFAULT_EPOCH;
+
+    printf("================ Row limit (t=%d k=%d r=%lld, target %d per mille every %d rows) ================\n", t, k,
+           r, target, epoch);
+    printf("%-14s %12s %12s %12s %10s %12s %14s\n", "Row limit", "Signatures", "Key usage", "Mean rows",
+           "Last limit", "Adjustments", "ns/signature");
+    char label[32];
+    for (int rt = min_rows; rt <= max_rows; rt = rt < max_rows && rt * 2 > max_rows ? max_rows : rt * 2) {
+        snprintf(label, sizeof(label), "fixed %d", rt);
+        if (!bench_row_limit_run(label, t, k, r, rt, rt, target, epoch))
+            return 1;
+    }
+    snprintf(label, sizeof(label), "adaptive %d-%d", min_rows, max_rows);
+    return !bench_row_limit_run(label, t, k, r, max_rows, min_rows, target, epoch);
+}
+
+
+/*
+ *
+ *  Extension suite: window extensions, discarded bits and time per signature for runs of signatures per extension
+ *
+ */
+static int bench_extension(int argc, char **argv) {
+    if (argc < 4) {
+        printf("mumhors_bench extension T K RT R [RUN ...]\n");
+        return 1;
+    }
+    const int t = atoi(argv[0]);
+    const int k = atoi(argv[1]);
+    const int rt = atoi(argv[2]);
+    const long long r = atoll(argv[3]);
+
+    /* The runs on the command line, or powers of two up to t / k */
+    int runs[32], num_runs = 0;
+    if (argc > 4) {
+        for (int i = 4; i < argc && num_runs < 32; i++)
+            runs[num_runs++] = atoi(argv[i]);
+    } else {
+        for (int run = 1; run < t / k; run *= 2)
+            runs[num_runs++] = run;
+        runs[num_runs++] = t / k;
+    }
+
+    printf("================ Extension runs (t=%d k=%d rt=%d r=%lld) ================\n", t, k, rt, r);
+    printf("%-6s %12s %12s %14s %16s %14s\n", "Run", "Signatures", "Extensions", "Sig/extension", "Discarded bits",
+           "ns/signature");
+    for (int i = 0; i < num_runs; i++) {
+        simulation_config_t config;
+        simulation_result_t result;
+        simulation_config_init(&config, t, k, r, rt);
+        config.run = runs[i];
+        simulation_run(&config, &result);
+        if (result.failed) {
+            printf("Cannot allocate a bitmap of %d rows of %d columns\n", rt, t);
+            return 1;
+        }
+
+        printf("%-6d %12lld %12lld %14.1f %15.2f%% %14.1f\n", runs[i], result.signatures, result.extensions,
+               (double) result.signatures / result.extensions, 100.0 * result.discarded_bits / ((double) r * t),
+               result.seconds * 1.0e9 / result.signatures);
+    }
+    printf("Extensions count the extensions that allocated rows; discarded bits are a share of the r * t keys\n");
+    return 0;
+}
+
+
+typedef struct bench_suite {
+    const char *name; /* Name on the command line */
+    const char *usage; /* Arguments of the suite */
+    int (*run)(int argc, char **argv); /* Runs the suite with its arguments */
+} bench_suite_t;
+
+static const bench_suite_t bench_suites[] = {
+    {"digest", "[MAX_SIZE] [THREADS]", bench_digest},
+    {"batch", "T K RT SIGNATURES", bench_batch},
+    {"columns", "K RT SIGNATURES [T_MIN] [T_MAX]", bench_columns},
+    {"snapshot", "T K RT SIGNATURES [CHECKPOINTS]", bench_snapshot},
+    {"eviction", "T K RT R [POLICY[:PARAM] ...]", bench_eviction},
+    {"rowlimit", "T K R MIN MAX [TARGET] [EPOCH]", bench_row_limit},
+    {"extension", "T K RT R [RUN ...]", bench_extension},
+};
+
+
+int main(int argc, char **argv) {
+    int num_suites = sizeof(bench_suites) / sizeof(bench_suites[0]);
+    for (int i = 0; argc > 1 && i < num_suites; i++)
+        if (!strcmp(argv[1], bench_suites[i].name))
+            return bench_suites[i].run(argc - 2, argv + 2);
+
+    printf("|HELP|\n\tRun:\n");
+    for (int i = 0; i < num_suites; i++)
+        printf("\t\t mumhors_bench %s %s\n", bench_suites[i].name, bench_suites[i].usage);
+    exit(1);
+}
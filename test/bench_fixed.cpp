@@ -0,0 +1,116 @@
+#include "mumhors_fixed.hpp"
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <sys/time.h>
+
+/* Compares the generic C signer/verifier with the compile-time specialized ones of mumhors_fixed.hpp. Both sign
+ * the same message sequence, the signatures must be byte-identical and accepted by both verifiers. */
+
+static double elapsed(const struct timeval &start, const struct timeval &end) {
+    return (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1.0e6;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 8) {
+        printf("|HELP|\n\tRun:\n");
+        printf("\t\t mumhors_fixed_bench T K L R RT TESTS SEED_FILE\n");
+        exit(1);
+    }
+    FILE *fp = fopen(argv[7], "r");
+    assert(fp != NULL);
+    fseek(fp, 0L, SEEK_END);
+    int seed_len = ftell(fp);
+    fseek(fp, 0L, SEEK_SET);
+    std::vector<unsigned char> seed(seed_len);
+    fread(seed.data(), seed_len, 1, fp);
+    fclose(fp);
+
+    const int t = atoi(argv[1]);
+    const int k = atoi(argv[2]);
+    const int l = atoi(argv[3]);
+    const long long r = atoll(argv[4]);
+    const int rt = atoi(argv[5]);
+    const int tests = atoi(argv[6]);
+
+    public_key_matrix_t fixed_pk_matrix;
+    mumhors_pk_gen(&fixed_pk_matrix, seed.data(), seed_len, r, t);
+    /* The C signer and verifier keep their default settings, the only ones of the fixed layer */
+    auto fixed_signer = mumhors::make_fixed_signer(t, k, l, rt, seed.data(), seed_len, r, EVICTION_FEWEST, 0, rt, 1);
+    auto fixed_verifier = mumhors::make_fixed_verifier(t, k, l, rt, fixed_pk_matrix, r, EVICTION_FEWEST, 0, rt, 1);
+    if (!fixed_signer || !fixed_verifier) {
+        printf("No specialized signer for t=%d k=%d l=%d rt=%d (see mumhors::fixed_parameter_sets)\n", t, k, l, rt);
+        exit(1);
+    }
+
+    mumhors_signer_t signer;
+    mumhors_verifier_t verifier;
+    public_key_matrix_t pk_matrix;
+    mumhors_pk_gen(&pk_matrix, seed.data(), seed_len, r, t);
+    if (mumhors_init_signer(&signer, seed.data(), seed_len, t, k, l, rt, r, NULL) != MUMHORS_INIT_SUCCESS ||
+        mumhors_init_verifier(&verifier, pk_matrix, t, k, l, r, t, rt, t) != MUMHORS_INIT_SUCCESS) {
+        printf("Cannot allocate a window of %d rows of %d keys for the signer and the verifier\n", rt, t);
+        exit(1);
+    }
+
+    unsigned char message[SHA256_OUTPUT_LEN];
+    blake2b_256(message, seed.data(), seed_len);
+
+    double generic_sign_time = 0, generic_verify_time = 0, fixed_sign_time = 0, fixed_verify_time = 0;
+    int signed_messages = 0, mismatches = 0, generic_rejected = 0, fixed_rejected = 0;
+    struct timeval start_time, end_time;
+
+    for (int message_index = 0; message_index < tests; message_index++) {
+        gettimeofday(&start_time, NULL);
+        int fixed_sign_status = fixed_signer->sign(message, SHA256_OUTPUT_LEN);
+        gettimeofday(&end_time, NULL);
+        fixed_sign_time += elapsed(start_time, end_time);
+
+        gettimeofday(&start_time, NULL);
+        if (fixed_verifier->verify(fixed_signer->signature(), message, SHA256_OUTPUT_LEN) ==
+            VERIFY_SIGNATURE_INVALID)
+            fixed_rejected++;
+        gettimeofday(&end_time, NULL);
+        fixed_verify_time += elapsed(start_time, end_time);
+
+        gettimeofday(&start_time, NULL);
+        int sign_status = mumhors_sign_message(&signer, message, SHA256_OUTPUT_LEN);
+        gettimeofday(&end_time, NULL);
+        generic_sign_time += elapsed(start_time, end_time);
+
+        gettimeofday(&start_time, NULL);
+        if (mumhors_verify_signature(&verifier, &signer.signature, message, SHA256_OUTPUT_LEN) ==
+            VERIFY_SIGNATURE_INVALID)
+            generic_rejected++;
+        gettimeofday(&end_time, NULL);
+        generic_verify_time += elapsed(start_time, end_time);
+
+        const mumhors_signature_t &fixed_signature = fixed_signer->signature();
+        if (sign_status != fixed_sign_status || signer.signature.stage != fixed_signature.stage ||
+            signer.signature.ctr != fixed_signature.ctr ||
+            memcmp(signer.signature.signature, fixed_signature.signature, k * SHA256_OUTPUT_LEN) != 0)
+            mismatches++;
+
+        signed_messages++;
+        if (fixed_sign_status == SIGN_NO_MORE_ROW_FAILED)
+            break;
+        blake2b_256(message, message, SHA256_OUTPUT_LEN);
+    }
+
+    printf("================ MUM-HORS fixed vs generic ================\n");
+    printf("Parameters: t=%d k=%d l=%d r=%lld rt=%d, %d messages\n", t, k, l, r, rt, signed_messages);
+    printf("Fixed   sign: %0.3f us/msg, verify: %0.3f us/msg, rejected: %d\n",
+           fixed_sign_time * 1.0e6 / signed_messages, fixed_verify_time * 1.0e6 / signed_messages, fixed_rejected);
+    printf("Generic sign: %0.3f us/msg, verify: %0.3f us/msg, rejected: %d\n",
+           generic_sign_time * 1.0e6 / signed_messages, generic_verify_time * 1.0e6 / signed_messages,
+           generic_rejected);
+    printf("Speedup sign: %0.2fx, verify: %0.2fx\n", generic_sign_time / fixed_sign_time,
+           generic_verify_time / fixed_verify_time);
+    printf("Mismatching signatures: %d\n", mismatches);
+    mumhors_delete_verifier(&verifier);
+    mumhors_delete_signer(&signer);
+
+    return mismatches || fixed_rejected != generic_rejected ? 1 : 0;
+}
@@ -0,0 +1,249 @@
+#include "bitmap.h"
+#include "bitmap_snapshot.h"
+#include "simulation.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* Bitmap micro-benchmarks: the operations of the signer's bitmap on windows of rt rows whose bits follow a fill
+ * level, for every engine. The window of a fill level is written once as a snapshot and restored before each trial
+ * (untimed), so every engine and trial starts from the same rows. The operations take from tens of nanoseconds, so
+ * they are timed with the monotonic clock instead of gettimeofday. */
+#define BITMAP_BENCH_DEFAULT_TS "1024,16384,262144"
+#define BITMAP_BENCH_DEFAULT_RTS "4,11,32"
+#define BITMAP_BENCH_DEFAULT_K 16
+#define BITMAP_BENCH_DEFAULT_TRIALS 7
+#define BITMAP_BENCH_WARMUP 2 /* Untimed trials before the timed ones */
+#define BITMAP_BENCH_LOOKUPS 1024 /* Lookups of a select trial */
+#define BITMAP_BENCH_SIGNATURES 64 /* Batched select-and-clears of a trial (at most a tenth of the set bits) */
+#define BITMAP_BENCH_EXTENSIONS 16 /* Extensions of a cleanup, eviction or allocation trial */
+#define BITMAP_BENCH_MAX_LIST 16 /* Values of t or rt on the command line */
+#define BITMAP_BENCH_SPARSE_PERCENT 3 /* Set bits of the old rows in the sparse-tail level */
+
+/* Fill levels of the window */
+#define FILL_FRESH 0 /* Every row full, as after the allocation */
+#define FILL_HALF 1 /* Every row with half of its bits set, at random */
+#define FILL_SPARSE_TAIL 2 /* The newest row full, the older ones nearly empty (BITMAP_BENCH_SPARSE_PERCENT) */
+#define FILL_NUM_LEVELS 3
+static const char *const fill_names[FILL_NUM_LEVELS] = {"fresh", "half", "sparse-tail"};
+
+/* Operations */
+#define OP_SELECT 0 /* One lookup of a random index */
+#define OP_BATCH 1 /* One select-and-clear of k random indices */
+#define OP_CLEANUP 2 /* An extension that drops an empty row and allocates one */
+#define OP_EVICTION 3 /* An extension that evicts the row with the fewest set bits and allocates one */
+#define OP_ALLOCATION 4 /* An extension that allocates one row into a free slot */
+#define OP_NUM 5
+static const char *const op_names[OP_NUM] = {"select", "batch", "cleanup", "eviction", "allocation"};
+
+
+/// Returns the time of the monotonic clock
+/// \return Time in nanoseconds
+static double bench_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1.0e9 + now.tv_nsec;
+}
+
+
+/// Returns the share of set bits of a row of a fill level
+/// \param fill Fill level (FILL_*)
+/// \param position Window position of the row
+/// \param rows Number of rows of the window
+/// \return Share of the bits of the row that are set
+static double fill_density(int fill, int position, int rows) {
+    switch (fill) {
+        case FILL_FRESH:
+            return 1;
+        case FILL_HALF:
+            return 0.5;
+        default:
+            return position == rows - 1 ? 1 : BITMAP_BENCH_SPARSE_PERCENT / 100.0;
+    }
+}
+
+
+/// Writes the snapshot of a full window of a fill level
+/// \param t Number of columns
+/// \param rt Number of rows of the window
+/// \param fill Fill level (FILL_*)
+/// \param op Operation the window is for: the first row is empty for OP_CLEANUP and left out for OP_ALLOCATION
+/// \param buffer Output buffer
+/// \param set_bits Pointer to variable which will store the set bits of the window
+/// \return Size of the snapshot in bytes
+static size_t fill_snapshot(int t, int rt, int fill, int op, unsigned char *buffer, long long *set_bits) {
+    int words = (t + 63) / 64;
+    uint64_t data[words];
+    uint64_t state = SIMULATION_DEFAULT_SEED + fill;
+    unsigned char *rows = buffer + bitmap_snapshot_header_bound();
+    size_t written = 0;
+    int first = op == OP_ALLOCATION;
+    *set_bits = 0;
+    for (int position = first; position < rt; position++) {
+        /* The bits are set at random with the density of the row, or all of them */
+        double density = op == OP_CLEANUP && position == 0 ? 0 : fill_density(fill, position, rt);
+        for (int w = 0; w < words; w++) {
+            data[w] = 0;
+            for (int bit = 0; bit < 64 && w * 64 + bit < t; bit++)
+                if (density >= 1 || (double) (simulation_random(&state) >> 11) / (1ULL << 53) < density)
+                    data[w] |= 1ULL << bit;
+            *set_bits += __builtin_popcountll(data[w]);
+        }
+        written += bitmap_snapshot_put_varint(rows + written, position == first ? position : 0);
+        written += bitmap_snapshot_encode_row(data, t, rows + written);
+    }
+
+    bitmap_snapshot_header_t header = {
+        rt + BITMAP_BENCH_EXTENSIONS, t, rt, t, rt, rt - first, *set_bits,
+        EVICTION_FEWEST, 0, rt, rt, ROW_LIMIT_DEFAULT_TARGET, ROW_LIMIT_DEFAULT_EPOCH, 0, 0, 0, 0, 0
+    };
+    size_t header_bytes = bitmap_snapshot_write_header(&header, buffer);
+    memmove(buffer + header_bytes, rows, written);
+    return header_bytes + written;
+}
+
+
+/// Times one trial of an operation
+/// \param engine Bitmap engine
+/// \param op Operation (OP_*)
+/// \param k Indices of a batched select-and-clear
+/// \param snapshot Snapshot of the window of the operation
+/// \param length Size of the snapshot in bytes
+/// \param state Pointer to the state of the random indices
+/// \return Nanoseconds per operation, or a negative number if the snapshot cannot be restored
+static double bench_trial(const bitmap_engine_t *engine, int op, int k, const unsigned char *snapshot, size_t length,
+                          uint64_t *state) {
+    bitmap_t bm;
+    if (bitmap_restore(&bm, engine, snapshot, length) != BITMAP_RESTORE_SUCCESS)
+        return -1;
+    double elapsed = 0, start;
+    int ops = 0;
+    int indices[k], sorted_indices[k], cols[k];
+    long long rows[k];
+
+    switch (op) {
+        case OP_SELECT: {
+            /* The lookups are drawn first and timed together, they take about as long as reading the clock */
+            int lookups[BITMAP_BENCH_LOOKUPS];
+            for (int i = 0; i < BITMAP_BENCH_LOOKUPS; i++)
+                lookups[i] = (int) (simulation_random(state) % bm.set_bits);
+            start = bench_now();
+            for (; ops < BITMAP_BENCH_LOOKUPS; ops++)
+                bitmap_get_row_colum_with_index(&bm, lookups[ops], rows, cols);
+            elapsed = bench_now() - start;
+            break;
+        }
+        case OP_BATCH:
+            for (; ops < BITMAP_BENCH_SIGNATURES && (ops + 1) * k * 10LL <= bm.set_bits; ops++) {
+                simulation_draw_indices(state, (int) (bm.set_bits < bm.window_size ? bm.set_bits : bm.window_size),
+                                        k, indices, sorted_indices);
+                start = bench_now();
+                bitmap_select_and_clear(&bm, indices, sorted_indices, k, rows, cols);
+                elapsed += bench_now() - start;
+            }
+            break;
+        default:
+            /* Each extension runs on a window restored from the snapshot, whose window size is one more than its set
+             * bits so one row is allocated (a full window holds more bits than a snapshot's window size can ask) */
+            for (; ops < BITMAP_BENCH_EXTENSIONS; ops++) {
+                if (ops) {
+                    bitmap_delete(&bm);
+                    bitmap_restore(&bm, engine, snapshot, length);
+                }
+                bm.window_size = (int) bm.set_bits + 1;
+                start = bench_now();
+                bitmap_extend_matrix(&bm);
+                elapsed += bench_now() - start;
+            }
+    }
+    bitmap_delete(&bm);
+    return ops ? elapsed / ops : 0;
+}
+
+
+/// Compares two times for qsort
+/// \param a Pointer to the first time
+/// \param b Pointer to the second time
+/// \return Negative, zero or positive as the first time is smaller, equal or larger
+static int compare_times(const void *a, const void *b) {
+    double x = *(const double *) a, y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+
+/// Parses a comma-separated list of positive numbers
+/// \param list The list
+/// \param values Array which will store the numbers (BITMAP_BENCH_MAX_LIST values)
+/// \return Number of values, or 0 if one of them is not positive
+static int parse_list(const char *list, int *values) {
+    int count = 0;
+    for (const char *value = list; value && count < BITMAP_BENCH_MAX_LIST; value = strchr(value, ',')) {
+        if (*value == ',')
+            value++;
+        if ((values[count++] = atoi(value)) <= 0)
+            return 0;
+    }
+    return count;
+}
+
+
+int main(int argc, char **argv) {
+    int ts[BITMAP_BENCH_MAX_LIST], rts[BITMAP_BENCH_MAX_LIST];
+    int num_ts = parse_list(argc > 1 ? argv[1] : BITMAP_BENCH_DEFAULT_TS, ts);
+    int num_rts = parse_list(argc > 2 ? argv[2] : BITMAP_BENCH_DEFAULT_RTS, rts);
+    const int k = argc > 3 ? atoi(argv[3]) : BITMAP_BENCH_DEFAULT_K;
+    const int trials = argc > 4 ? atoi(argv[4]) : BITMAP_BENCH_DEFAULT_TRIALS;
+    int valid = num_ts && num_rts && k >= 1 && trials >= 1;
+    for (int i = 0; i < num_ts; i++)
+        valid &= ts[i] % 8 == 0 && ts[i] > 10 * k;
+    if (!valid) {
+        printf("|HELP|\n\tRun:\n");
+        printf("\t\t mumhors_bitmap_bench [T,...] [RT,...] [K] [TRIALS]\n");
+        printf("\tDefaults: T %s, RT %s, K %d, TRIALS %d (T is a multiple of 8, more than 10 * K)\n",
+               BITMAP_BENCH_DEFAULT_TS, BITMAP_BENCH_DEFAULT_RTS, BITMAP_BENCH_DEFAULT_K, BITMAP_BENCH_DEFAULT_TRIALS);
+        exit(1);
+    }
+
+    printf("================ Bitmap operations (k=%d, median of %d trials after %d warmup trials, ns/op) "
+           "================\n", k, trials, BITMAP_BENCH_WARMUP);
+    printf("%-8s %-4s %-12s %-11s", "t", "rt", "Fill", "Operation");
+    for (int e = 0; e < BITMAP_NUM_ENGINES; e++)
+        printf(" %12s", bitmap_engines[e]->name);
+    printf("\n");
+
+    for (int i = 0; i < num_ts; i++) {
+        for (int j = 0; j < num_rts; j++) {
+            const int t = ts[i], rt = rts[j];
+            unsigned char *snapshot = malloc(bitmap_snapshot_header_bound() +
+                                             (size_t) rt * (BITMAP_SNAPSHOT_VARINT_MAX + bitmap_snapshot_row_bound(t)));
+            for (int fill = 0; fill < FILL_NUM_LEVELS; fill++) {
+                for (int op = 0; op < OP_NUM; op++) {
+                    /* A window without another row to evict or drop has nothing to measure */
+                    if (rt == 1 && op >= OP_CLEANUP)
+                        continue;
+                    long long set_bits;
+                    size_t length = fill_snapshot(t, rt, fill, op, snapshot, &set_bits);
+                    printf("%-8d %-4d %-12s %-11s", t, rt, fill_names[fill], op_names[op]);
+                    for (int e = 0; e < BITMAP_NUM_ENGINES; e++) {
+                        double times[trials];
+                        uint64_t state = SIMULATION_DEFAULT_SEED;
+                        for (int trial = -BITMAP_BENCH_WARMUP; trial < trials; trial++) {
+                            double time = bench_trial(bitmap_engines[e], op, k, snapshot, length, &state);
+                            if (trial >= 0)
+                                times[trial] = time;
+                        }
+                        qsort(times, trials, sizeof(double), compare_times);
+                        printf(" %12.1f", times[trials / 2]);
+                    }
+                    printf("\n");
+                }
+            }
+            free(snapshot);
+        }
+    }
+    printf("batch times one select-and-clear of k indices; cleanup, eviction and allocation time the extension "
+           "that allocates one row\n");
+    return 0;
+}
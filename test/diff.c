@@ -0,0 +1,683 @@
+#include "mumhors.h"
+#include "simulation.h"
+#include "hash.h"
+#include "diff.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Differential driver: every bitmap engine runs side by side with the list engine (the reference) on the same index
+ * sequences, randomized or adversarial, with random hyperparameters, eviction policies, row limits and extension
+ * runs. After each signature the lanes must give the same (row, col) for every index and the same window after the
+ * extension. Two more lanes take the reference's k lookups and unset pass instead of the batched select-and-clear,
+ * and a restore of the reference's snapshot into a rotating engine every DIFF_SNAPSHOT_PERIOD signatures. Some cases
+ * also sign messages with a signer per engine and verify them with the verifier, which must accept every signature
+ * and keep the window of the signer. Others run the C signer and verifier against the fixed layer (see
+ * diff_fixed.cpp) for each set of mumhors::fixed_parameter_sets in turn. The first divergence stops the driver; for a
+ * bitmap or fixed case, the index sequence or message numbers are cut down to smaller ones that still diverge and
+ * written as a reproducer for `mumhors_diff replay`. */
+#define DIFF_DEFAULT_CASES 200
+#define DIFF_DEFAULT_SIGNATURES 20000 /* Signatures of a case at most (it stops earlier when the rows run out) */
+#define DIFF_SNAPSHOT_PERIOD 61 /* Signatures between two restores of the snapshot lane */
+#define DIFF_MINIMIZE_RUNS 256 /* Runs of the lanes spent on cutting down a diverging sequence */
+#define DIFF_VERIFIER_PERIOD 4 /* Every fourth case signs and verifies messages */
+#define DIFF_VERIFIER_KEYS (1 << 17) /* Public keys of a verifier or fixed case at most */
+#define DIFF_FIXED_PERIOD 8 /* Every eighth case (the second one) runs the fixed layer */
+#define DIFF_FIXED_MINIMIZE_RUNS 64 /* Runs of a fixed case spent on cutting down diverging messages (each one
+                                     * generates the public keys twice) */
+#define DIFF_REPRODUCER "mumhors_diff.repro"
+
+/* Index sequences */
+#define MODE_UNIFORM 0 /* Uniform indices, as signatures draw them */
+#define MODE_LOW 1 /* Indices among the first 2k of the window (the oldest rows deplete first) */
+#define MODE_HIGH 2 /* Indices among the last 2k of the window (the newest rows deplete first) */
+#define MODE_WORDS 3 /* Indices at the first and last bit of 64-bit words */
+#define MODE_BURST 4 /* k consecutive indices from a random start */
+#define MODE_MIXED 5 /* One of the modes above for each signature */
+#define MODE_NUM 6
+static const char *const mode_names[MODE_NUM] = {"uniform", "low", "high", "words", "burst", "mixed"};
+
+/* Lanes: one per engine (the first is the reference), then the separate calls and the restored snapshots. The fixed
+ * layer is the lane of the fixed cases. */
+#define DIFF_SEPARATE_LANE BITMAP_NUM_ENGINES
+#define DIFF_RESTORED_LANE (BITMAP_NUM_ENGINES + 1)
+#define DIFF_NUM_LANES (BITMAP_NUM_ENGINES + 2)
+#define DIFF_FIXED_LANE DIFF_NUM_LANES
+
+
+int diff_check(diff_divergence_t *divergence, long long signature, int lane, const char *what, long long expected,
+               long long actual) {
+    if (expected == actual)
+        return 0;
+    if (divergence->signature < 0) {
+        divergence->signature = signature;
+        divergence->lane = lane;
+        snprintf(divergence->what, sizeof(divergence->what), "%s", what);
+        divergence->expected = expected;
+        divergence->actual = actual;
+    }
+    return 1;
+}
+
+
+/// Compares the windows of two bitmaps after an extension
+/// \param divergence Pointer to the divergence
+/// \param signature Signature number
+/// \param lane Lane number
+/// \param reference Bitmap of the reference
+/// \param bm Bitmap of the lane
+/// \return 1 if the windows differ
+static int diff_check_window(diff_divergence_t *divergence, long long signature, int lane, const bitmap_t *reference,
+                             const bitmap_t *bm) {
+    return diff_check(divergence, signature, lane, "next row number", reference->nxt_row_number,
+                      bm->nxt_row_number) ||
+           diff_check(divergence, signature, lane, "active rows", reference->active_rows, bm->active_rows) ||
+           diff_check(divergence, signature, lane, "set bits", reference->set_bits, bm->set_bits) ||
+           diff_check(divergence, signature, lane, "discarded bits", reference->discarded_bits, bm->discarded_bits) ||
+           diff_check(divergence, signature, lane, "discarded rows", reference->discarded_rows, bm->discarded_rows) ||
+           diff_check(divergence, signature, lane, "row limit", reference->row_limit.limit, bm->row_limit.limit);
+}
+
+
+/// Draws one candidate index of a signature
+/// \param state Pointer to the random state
+/// \param mode Index sequence (MODE_*, not MODE_MIXED)
+/// \param t Window size
+/// \param k Number of indices
+/// \param attempt Number of the candidate in the signature
+/// \param start Random start of the signature
+/// \return Index in the window
+static int diff_candidate(uint64_t *state, int mode, int t, int k, int attempt, int start) {
+    uint64_t value = simulation_random(state);
+    switch (mode) {
+        case MODE_LOW:
+            return (int) (value % (2 * k));
+        case MODE_HIGH:
+            return t - 1 - (int) (value % (2 * k));
+        case MODE_WORDS: {
+            int index = (int) (value % ((t + 63) / 64)) * 64 + (value >> 32 & 1 ? 63 : 0);
+            return index < t ? index : t - 1;
+        }
+        case MODE_BURST:
+            return (start + attempt) % t;
+        default:
+            return (int) (value % t);
+    }
+}
+
+/// Draws the distinct indices of a signature
+/// \param state Pointer to the random state
+/// \param mode Index sequence (MODE_*)
+/// \param t Window size
+/// \param k Number of indices
+/// \param indices Array which will store the indices (in drawing order)
+static void diff_draw(uint64_t *state, int mode, int t, int k, int *indices) {
+    if (mode == MODE_MIXED)
+        mode = (int) (simulation_random(state) % MODE_MIXED);
+    int start = (int) (simulation_random(state) % t);
+    /* A mode with too few candidates for k distinct indices falls back to uniform ones */
+    for (int i = 0, attempt = 0; i < k; attempt++) {
+        int index = diff_candidate(state, attempt < 4 * k ? mode : MODE_UNIFORM, t, k, attempt, start);
+        int repeated = 0;
+        for (int j = 0; j < i && !repeated; j++)
+            repeated = indices[j] == index;
+        if (!repeated)
+            indices[i++] = index;
+    }
+}
+
+/// Sorts the indices of a signature in descending order
+/// \param indices Indices
+/// \param k Number of indices
+/// \param sorted_indices Array which will store the sorted indices
+static void diff_sort(const int *indices, int k, int *sorted_indices) {
+    for (int i = 0; i < k; i++) {
+        int position = i;
+        while (position > 0 && sorted_indices[position - 1] < indices[i]) {
+            sorted_indices[position] = sorted_indices[position - 1];
+            position--;
+        }
+        sorted_indices[position] = indices[i];
+    }
+}
+
+
+/// Initializes the bitmap of a lane with the hyperparameters of a case (the run stops if it cannot be allocated)
+/// \param bm Pointer to the bitmap structure
+/// \param engine Bitmap engine
+/// \param c Pointer to the case
+static void diff_bitmap_init(bitmap_t *bm, const bitmap_engine_t *engine, const diff_case_t *c) {
+    if (bitmap_init(bm, engine, c->r, c->t, c->rt, c->t) != BITMAP_INIT_SUCCESS) {
+        printf("\nCannot allocate the %s bitmap (rt=%d, t=%d)\n", engine->name, c->rt, c->t);
+        exit(1);
+    }
+    bitmap_set_eviction(bm, c->eviction_policy, c->eviction_param);
+    bitmap_set_row_limit(bm, c->rt_min, ROW_LIMIT_DEFAULT_TARGET, ROW_LIMIT_DEFAULT_EPOCH);
+    bitmap_set_headroom(bm, (c->run - 1) * c->k);
+}
+
+/// Returns the name of a lane
+/// \param lane Lane number
+/// \return Name
+static const char *diff_lane_name(int lane) {
+    if (lane == DIFF_SEPARATE_LANE)
+        return "separate";
+    if (lane == DIFF_RESTORED_LANE)
+        return "restored";
+    if (lane == DIFF_FIXED_LANE)
+        return "fixed";
+    return bitmap_engines[lane]->name;
+}
+
+
+/// Runs the lanes of a bitmap case up to the first divergence
+/// \param c Pointer to the case
+/// \param sequence Indices of the signatures, k per signature (filled from the seed if generate is set)
+/// \param length Number of signatures of the sequence (ignored if generate is set)
+/// \param generate Whether the indices are drawn from the seed of the case
+/// \param divergence Pointer to the divergence which will be filled
+/// \return Number of signatures run
+static long long diff_run(const diff_case_t *c, int *sequence, long long length, int generate,
+                          diff_divergence_t *divergence) {
+    const int k = c->k;
+    bitmap_t bms[DIFF_NUM_LANES];
+    for (int lane = 0; lane < DIFF_NUM_LANES; lane++)
+        diff_bitmap_init(&bms[lane], lane < BITMAP_NUM_ENGINES ? bitmap_engines[lane] : bitmap_engines[0], c);
+    unsigned char *snapshot = malloc(bitmap_snapshot_size_bound(&bms[0]));
+    int restores = 0;
+
+    int sorted_indices[k], unset_indices[k], cols[DIFF_NUM_LANES][k];
+    long long rows[DIFF_NUM_LANES][k];
+    uint64_t state = c->seed;
+    divergence->signature = -1;
+    long long n = 0;
+    for (int failed = 0; !failed && n < (generate ? c->signatures : length); n++) {
+        int *indices = sequence + n * k;
+        if (generate)
+            diff_draw(&state, c->mode, c->t, k, indices);
+        diff_sort(indices, k, sorted_indices);
+
+        /* The snapshot lane starts again from the window of the reference, in the next engine */
+        if (n && n % DIFF_SNAPSHOT_PERIOD == 0) {
+            size_t snapshot_length = bitmap_snapshot(&bms[0], snapshot);
+            bitmap_delete(&bms[DIFF_RESTORED_LANE]);
+            if (bitmap_restore(&bms[DIFF_RESTORED_LANE], bitmap_engines[restores++ % BITMAP_NUM_ENGINES], snapshot,
+                               snapshot_length) != BITMAP_RESTORE_SUCCESS) {
+                diff_check(divergence, n, DIFF_RESTORED_LANE, "restore", BITMAP_RESTORE_SUCCESS,
+                           BITMAP_RESTORE_FAILED);
+                diff_bitmap_init(&bms[DIFF_RESTORED_LANE], bitmap_engines[0], c);
+                failed = 1;
+            }
+        }
+
+        int status[DIFF_NUM_LANES];
+        for (int lane = 0; lane < DIFF_NUM_LANES && !failed; lane++) {
+            if (lane == DIFF_SEPARATE_LANE) {
+                for (int i = 0; i < k; i++)
+                    bitmap_get_row_colum_with_index(&bms[lane], indices[i], &rows[lane][i], &cols[lane][i]);
+                memcpy(unset_indices, sorted_indices, sizeof(unset_indices));
+                bitmap_unset_indices_in_window(&bms[lane], unset_indices, k);
+            } else {
+                bitmap_select_and_clear(&bms[lane], indices, sorted_indices, k, rows[lane], cols[lane]);
+            }
+            for (int i = 0; i < k && !failed; i++)
+                failed = diff_check(divergence, n, lane, "row", rows[0][i], rows[lane][i]) ||
+                         diff_check(divergence, n, lane, "column", cols[0][i], cols[lane][i]);
+
+            status[lane] = bitmap_extend_matrix(&bms[lane]);
+            failed = failed || diff_check(divergence, n, lane, "extension status", status[0], status[lane]) ||
+                     diff_check_window(divergence, n, lane, &bms[0], &bms[lane]);
+        }
+        /* The reference ran out of rows */
+        failed = failed || status[0] == BITMAP_EXTENSION_FAILED;
+    }
+
+    for (int lane = 0; lane < DIFF_NUM_LANES; lane++)
+        bitmap_delete(&bms[lane]);
+    free(snapshot);
+    return n;
+}
+
+
+/// Cuts chunks of signatures out of a diverging sequence while it still diverges, halving the chunks down to single
+/// signatures (within DIFF_MINIMIZE_RUNS runs)
+/// \param c Pointer to the case
+/// \param sequence Indices of the signatures (cut down in place)
+/// \param length Number of signatures of the sequence
+/// \return Number of signatures of the cut down sequence
+static long long diff_minimize(const diff_case_t *c, int *sequence, long long length) {
+    const int k = c->k;
+    int *candidate = malloc(sizeof(int) * k * length);
+    diff_divergence_t divergence;
+    int runs = 0;
+    for (long long chunk = length / 2; chunk >= 1 && runs < DIFF_MINIMIZE_RUNS; chunk /= 2) {
+        for (long long start = 0; start < length && length > 1 && runs < DIFF_MINIMIZE_RUNS;) {
+            long long end = start + chunk < length ? start + chunk : length;
+            memcpy(candidate, sequence, sizeof(int) * k * start);
+            memcpy(candidate + start * k, sequence + end * k, sizeof(int) * k * (length - end));
+            long long candidate_length = length - (end - start);
+            runs++;
+            diff_run(c, candidate, candidate_length, 0, &divergence);
+            if (divergence.signature >= 0) {
+                /* The sequence after the divergence is not needed either */
+                length = divergence.signature + 1;
+                memcpy(sequence, candidate, sizeof(int) * k * length);
+            } else {
+                start = end;
+            }
+        }
+    }
+    free(candidate);
+    return length;
+}
+
+
+/// Writes a reproducer: the hyperparameters of the case, then the indices of each signature
+/// \param path Path of the reproducer
+/// \param c Pointer to the case
+/// \param sequence Indices of the signatures
+/// \param length Number of signatures
+/// \return 1 if it was written
+static int diff_write_reproducer(const char *path, const diff_case_t *c, const int *sequence, long long length) {
+    FILE *fp = fopen(path, "w");
+    if (!fp)
+        return 0;
+    fprintf(fp, "%d %d %lld %d %d %d %d %d\n%lld\n", c->t, c->k, c->r, c->rt, c->rt_min, c->eviction_policy,
+            c->eviction_param, c->run, length);
+    for (long long n = 0; n < length; n++)
+        for (int i = 0; i < c->k; i++)
+            fprintf(fp, "%d%c", sequence[n * c->k + i], i == c->k - 1 ? '\n' : ' ');
+    fclose(fp);
+    return 1;
+}
+
+
+/// Cuts chunks of messages out of the diverging messages of a fixed case while they still diverge, like diff_minimize
+/// (within DIFF_FIXED_MINIMIZE_RUNS runs)
+/// \param c Pointer to the case
+/// \param messages Message numbers (cut down in place)
+/// \param length Number of messages
+/// \return Number of messages of the cut down sequence
+static long long diff_fixed_minimize(const diff_case_t *c, long long *messages, long long length) {
+    long long *candidate = malloc(sizeof(long long) * length);
+    diff_divergence_t divergence;
+    int runs = 0;
+    for (long long chunk = length / 2; chunk >= 1 && runs < DIFF_FIXED_MINIMIZE_RUNS; chunk /= 2) {
+        for (long long start = 0; start < length && length > 1 && runs < DIFF_FIXED_MINIMIZE_RUNS;) {
+            long long end = start + chunk < length ? start + chunk : length;
+            memcpy(candidate, messages, sizeof(long long) * start);
+            memcpy(candidate + start, messages + end, sizeof(long long) * (length - end));
+            long long candidate_length = length - (end - start);
+            runs++;
+            diff_fixed_run(c, candidate, candidate_length, DIFF_FIXED_LANE, &divergence);
+            if (divergence.signature >= 0) {
+                length = divergence.signature + 1;
+                memcpy(messages, candidate, sizeof(long long) * length);
+            } else {
+                start = end;
+            }
+        }
+    }
+    free(candidate);
+    return length;
+}
+
+
+/// Writes the reproducer of a fixed case: "fixed", the hyperparameters and the seed of the case, then the message
+/// numbers
+/// \param path Path of the reproducer
+/// \param c Pointer to the case
+/// \param messages Message numbers
+/// \param length Number of messages
+/// \return 1 if it was written
+static int diff_fixed_write_reproducer(const char *path, const diff_case_t *c, const long long *messages,
+                                       long long length) {
+    FILE *fp = fopen(path, "w");
+    if (!fp)
+        return 0;
+    fprintf(fp, "fixed %d %d %lld %d %d %d %d %d %llu\n%lld\n", c->t, c->k, c->r, c->rt, c->rt_min,
+            c->eviction_policy, c->eviction_param, c->run, (unsigned long long) c->seed, length);
+    for (long long n = 0; n < length; n++)
+        fprintf(fp, "%lld\n", messages[n]);
+    fclose(fp);
+    return 1;
+}
+
+
+/// Presents a case
+/// \param c Pointer to the case
+static void diff_print_case(const diff_case_t *c) {
+    printf("t=%d k=%d r=%lld rt=%d-%d eviction=%s:%d run=%d", c->t, c->k, c->r, c->rt_min, c->rt,
+           eviction_policy_names[c->eviction_policy], c->eviction_param, c->run);
+}
+
+/// Presents a divergence
+/// \param divergence Pointer to the divergence
+/// \param lane_name Name of the lane
+static void diff_print_divergence(const diff_divergence_t *divergence, const char *lane_name) {
+    printf("Divergence at signature %lld, %s: %s is %lld instead of %lld\n", divergence->signature, lane_name,
+           divergence->what, divergence->actual, divergence->expected);
+}
+
+
+/// Runs a verifier case: a signer per engine signs the same messages and the verifier checks the signatures of the
+/// first one. The signatures must be the same, the verifier must accept them, and after each signature that did not
+/// extend the signer's window (the verifier extends its window before the next verification) the windows must be
+/// the same.
+/// \param c Pointer to the case
+/// \param divergence Pointer to the divergence which will be filled
+/// \return Number of signatures
+static long long diff_verifier_run(const diff_case_t *c, diff_divergence_t *divergence) {
+    unsigned char seed[SHA256_OUTPUT_LEN], message[SHA256_OUTPUT_LEN];
+    blake2b_256(seed, (const unsigned char *) &c->seed, sizeof(c->seed));
+    blake2b_256(message, seed, sizeof(seed));
+
+    public_key_matrix_t pk_matrix;
+    mumhors_pk_gen(&pk_matrix, seed, sizeof(seed), c->r, c->t);
+    mumhors_verifier_t verifier;
+    if (mumhors_init_verifier(&verifier, pk_matrix, c->t, c->k, DIFF_L, c->r, c->t, c->rt, c->t) !=
+        MUMHORS_INIT_SUCCESS) {
+        printf("\nCannot allocate the verifier (rt=%d, t=%d)\n", c->rt, c->t);
+        exit(1);
+    }
+    mumhors_verifier_set_eviction(&verifier, c->eviction_policy, c->eviction_param);
+    mumhors_verifier_set_row_limit(&verifier, c->rt_min, ROW_LIMIT_DEFAULT_TARGET, ROW_LIMIT_DEFAULT_EPOCH);
+    mumhors_verifier_set_extension_run(&verifier, c->run);
+    mumhors_signer_t signers[BITMAP_NUM_ENGINES];
+    for (int e = 0; e < BITMAP_NUM_ENGINES; e++) {
+        if (mumhors_init_signer(&signers[e], seed, sizeof(seed), c->t, c->k, DIFF_L, c->rt, c->r,
+                                bitmap_engines[e]) != MUMHORS_INIT_SUCCESS) {
+            printf("\nCannot allocate the %s signer (rt=%d, t=%d)\n", bitmap_engines[e]->name, c->rt, c->t);
+            exit(1);
+        }
+        mumhors_signer_set_eviction(&signers[e], c->eviction_policy, c->eviction_param);
+        mumhors_signer_set_row_limit(&signers[e], c->rt_min, ROW_LIMIT_DEFAULT_TARGET, ROW_LIMIT_DEFAULT_EPOCH);
+        mumhors_signer_set_extension_run(&signers[e], c->run);
+    }
+
+    const bitmap_t *bm = &signers[0].bm;
+    divergence->signature = -1;
+    long long n = 0;
+    for (int failed = 0; !failed && n < c->signatures; n++) {
+        long long nxt_row_number = bm->nxt_row_number;
+        int status[BITMAP_NUM_ENGINES];
+        for (int e = 0; e < BITMAP_NUM_ENGINES && !failed; e++) {
+            status[e] = mumhors_sign_message(&signers[e], message, sizeof(message));
+            failed = diff_check(divergence, n, e, "signing status", status[0], status[e]) ||
+                     diff_check(divergence, n, e, "signature stage", signers[0].signature.stage,
+                                signers[e].signature.stage) ||
+                     diff_check(divergence, n, e, "signature counter", signers[0].signature.ctr,
+                                signers[e].signature.ctr) ||
+                     diff_check(divergence, n, e, "signature bytes", 0,
+                                memcmp(signers[0].signature.signature, signers[e].signature.signature,
+                                       c->k * DIFF_L / 8) != 0) ||
+                     (e && diff_check_window(divergence, n, e, bm, &signers[e].bm));
+        }
+        if (failed)
+            break;
+
+        /* The verifier stands for the signer of the first engine. The signature of a failed signing is complete (only
+         * the next ones have no window), so the verifier accepts it while the signer does not count it as issued. */
+        failed = diff_check(divergence, n, 0, "verification status", VERIFY_SIGNATURE_VALID,
+                            mumhors_verify_signature(&verifier, &signers[0].signature, message, sizeof(message)));
+        mumhors_capacity_t signer_capacity, verifier_capacity;
+        mumhors_signer_capacity(&signers[0], &signer_capacity);
+        mumhors_verifier_capacity(&verifier, &verifier_capacity);
+        failed = failed ||
+                 diff_check(divergence, n, 0, "verifier used keys", signer_capacity.used_keys,
+                            verifier_capacity.used_keys) ||
+                 diff_check(divergence, n, 0, "verifier signatures",
+                            signer_capacity.signatures + (status[0] == SIGN_NO_MORE_ROW_FAILED),
+                            verifier_capacity.signatures);
+        if (!failed && bm->nxt_row_number == nxt_row_number)
+            failed = diff_check(divergence, n, 0, "verifier next row number", bm->nxt_row_number,
+                                verifier.nxt_row_number) ||
+                     diff_check(divergence, n, 0, "verifier active rows", bm->active_rows, verifier.active_rows) ||
+                     diff_check(divergence, n, 0, "verifier available keys", bm->set_bits, verifier.active_pks) ||
+                     diff_check(divergence, n, 0, "verifier discarded keys", bm->discarded_bits,
+                                verifier.discarded_pks) ||
+                     diff_check(divergence, n, 0, "verifier discarded rows", bm->discarded_rows,
+                                verifier.discarded_rows) ||
+                     diff_check(divergence, n, 0, "verifier row limit", bm->row_limit.limit,
+                                verifier.row_limit.limit);
+        failed = failed || status[0] == SIGN_NO_MORE_ROW_FAILED;
+        blake2b_256(message, message, sizeof(message));
+    }
+
+    for (int e = 0; e < BITMAP_NUM_ENGINES; e++)
+        mumhors_delete_signer(&signers[e]);
+    mumhors_delete_verifier(&verifier);
+    return n;
+}
+
+
+/// Draws the hyperparameters of a case
+/// \param c Pointer to the case which will be filled
+/// \param state Pointer to the random state
+/// \param signatures Signatures at most
+/// \param verifier Whether the case signs and verifies messages (smaller matrices)
+static void diff_case_random(diff_case_t *c, uint64_t *state, long long signatures, int verifier) {
+    /* Bitmap cases: columns from 64 to 4096, a multiple of 8 but often not of 64, and up to 32768 in some cases.
+     * Verifier cases: a power of two from 64 to 1024, and the k indices within the bits of the message digest. */
+    int max_k = 64;
+    if (verifier) {
+        int bits = 6 + (int) (simulation_random(state) % 5);
+        c->t = 1 << bits;
+        max_k = 8 * SHA256_OUTPUT_LEN / bits;
+    } else if (simulation_random(state) % 8) {
+        c->t = 8 * (8 + (int) (simulation_random(state) % 505));
+    } else {
+        c->t = 8 * (512 + (int) (simulation_random(state) % 3585));
+    }
+    if (max_k > c->t / 8)
+        max_k = c->t / 8;
+    c->k = 1 + (int) (simulation_random(state) % max_k);
+    c->rt = 1 + (int) (simulation_random(state) % 16);
+    c->rt_min = simulation_random(state) % 2 ? c->rt : 1 + (int) (simulation_random(state) % c->rt);
+    long long max_rows = verifier ? DIFF_VERIFIER_KEYS / c->t : c->rt + 400;
+    c->r = c->rt + (long long) (simulation_random(state) % (max_rows > c->rt ? max_rows - c->rt + 1 : 1));
+    c->eviction_policy = (int) (simulation_random(state) % EVICTION_NUM_POLICIES);
+    c->eviction_param = 0;
+    if (c->eviction_policy == EVICTION_BELOW)
+        c->eviction_param = (int) (simulation_random(state) % (c->t / 2 + 1));
+    else if (c->eviction_policy == EVICTION_BATCH)
+        c->eviction_param = 1 + (int) (simulation_random(state) % c->rt);
+    c->run = simulation_random(state) % 2 ? 1 : 1 + (int) (simulation_random(state) % (c->t / c->k));
+    c->mode = (int) (simulation_random(state) % MODE_NUM);
+    c->signatures = signatures;
+    c->seed = simulation_random(state) | 1;
+}
+
+
+/// Draws a fixed case: the parameters of a set of the fixed layer, with random rows and seed
+/// \param c Pointer to the case which will be filled
+/// \param state Pointer to the random state
+/// \param signatures Signatures at most
+/// \param set Set number
+static void diff_fixed_case_random(diff_case_t *c, uint64_t *state, long long signatures, int set) {
+    diff_fixed_case(c, set);
+    long long max_rows = DIFF_VERIFIER_KEYS / c->t;
+    c->r = c->rt + (long long) (simulation_random(state) % (max_rows > c->rt ? max_rows - c->rt + 1 : 1));
+    c->mode = MODE_UNIFORM;
+    c->signatures = signatures;
+    c->seed = simulation_random(state) | 1;
+}
+
+
+/// Replays the reproducer of a fixed case (after its "fixed" word)
+/// \param fp Reproducer
+/// \param path Path of the reproducer
+/// \return 0 if the lanes agree, 1 if they diverge, 2 if the reproducer cannot be read
+static int diff_fixed_replay(FILE *fp, const char *path) {
+    diff_case_t c = {0};
+    unsigned long long seed;
+    long long length;
+    if (fscanf(fp, "%d %d %lld %d %d %d %d %d %llu %lld", &c.t, &c.k, &c.r, &c.rt, &c.rt_min, &c.eviction_policy,
+               &c.eviction_param, &c.run, &seed, &length) != 10 || c.k < 1 || length < 1 ||
+        c.eviction_policy < 0 || c.eviction_policy >= EVICTION_NUM_POLICIES) {
+        printf("Cannot read the reproducer %s\n", path);
+        fclose(fp);
+        return 2;
+    }
+    c.seed = seed;
+    long long *messages = malloc(sizeof(long long) * length);
+    for (long long i = 0; i < length; i++) {
+        if (fscanf(fp, "%lld", &messages[i]) != 1 || messages[i] < 0) {
+            printf("Cannot read the reproducer %s\n", path);
+            fclose(fp);
+            free(messages);
+            return 2;
+        }
+    }
+    fclose(fp);
+
+    printf("Replaying %lld messages on the fixed layer: ", length);
+    diff_print_case(&c);
+    printf("\n");
+    diff_divergence_t divergence;
+    long long done = diff_fixed_run(&c, messages, length, DIFF_FIXED_LANE, &divergence);
+    free(messages);
+    if (divergence.signature >= 0) {
+        diff_print_divergence(&divergence, diff_lane_name(divergence.lane));
+        return 1;
+    }
+    printf("No divergence in %lld messages\n", done);
+    return 0;
+}
+
+/// Replays a reproducer
+/// \param path Path of the reproducer
+/// \return 0 if the lanes agree, 1 if they diverge, 2 if the reproducer cannot be read
+static int diff_replay(const char *path) {
+    FILE *fp = fopen(path, "r");
+    diff_case_t c = {0};
+    long long length;
+    char word[8];
+    if (fp && fscanf(fp, " %7[a-z]", word) == 1) {
+        if (!strcmp(word, "fixed"))
+            return diff_fixed_replay(fp, path);
+        fclose(fp);
+        fp = NULL;
+    }
+    if (!fp || fscanf(fp, "%d %d %lld %d %d %d %d %d %lld", &c.t, &c.k, &c.r, &c.rt, &c.rt_min, &c.eviction_policy,
+                      &c.eviction_param, &c.run, &length) != 9 || c.k < 1 || length < 1 ||
+        c.eviction_policy < 0 || c.eviction_policy >= EVICTION_NUM_POLICIES) {
+        printf("Cannot read the reproducer %s\n", path);
+        if (fp)
+            fclose(fp);
+        return 2;
+    }
+    int *sequence = malloc(sizeof(int) * c.k * length);
+    for (long long i = 0; i < c.k * length; i++) {
+        if (fscanf(fp, "%d", &sequence[i]) != 1 || sequence[i] < 0 || sequence[i] >= c.t) {
+            printf("Cannot read the reproducer %s\n", path);
+            fclose(fp);
+            free(sequence);
+            return 2;
+        }
+    }
+    fclose(fp);
+
+    printf("Replaying %lld signatures: ", length);
+    diff_print_case(&c);
+    printf("\n");
+    diff_divergence_t divergence;
+    long long done = diff_run(&c, sequence, length, 0, &divergence);
+    free(sequence);
+    if (divergence.signature >= 0) {
+        diff_print_divergence(&divergence, diff_lane_name(divergence.lane));
+        return 1;
+    }
+    printf("No divergence in %lld signatures\n", done);
+    return 0;
+}
+
+
+int main(int argc, char **argv) {
+    if (argc > 1 && !strcmp(argv[1], "replay"))
+        return argc > 2 ? diff_replay(argv[2]) : diff_replay(DIFF_REPRODUCER);
+    const int cases = argc > 1 ? atoi(argv[1]) : DIFF_DEFAULT_CASES;
+    const long long signatures = argc > 2 ? atoll(argv[2]) : DIFF_DEFAULT_SIGNATURES;
+    uint64_t state = argc > 3 ? strtoull(argv[3], NULL, 0) | 1 : SIMULATION_DEFAULT_SEED;
+    if (cases < 1 || signatures < 1) {
+        printf("|HELP|\n\tRun:\n");
+        printf("\t\t mumhors_diff [CASES] [SIGNATURES] [SEED]\n");
+        printf("\t\t mumhors_diff replay [REPRODUCER]\n");
+        printf("\tDefaults: %d cases of at most %d signatures, reproducer %s\n", DIFF_DEFAULT_CASES,
+               DIFF_DEFAULT_SIGNATURES, DIFF_REPRODUCER);
+        exit(1);
+    }
+
+    printf("================ Differential run (%d cases, seed 0x%llx) ================\n", cases,
+           (unsigned long long) state);
+    long long total_signatures = 0, verified_signatures = 0, fixed_signatures = 0;
+    for (int i = 0; i < cases; i++) {
+        diff_case_t c;
+        int verifier = i % DIFF_VERIFIER_PERIOD == DIFF_VERIFIER_PERIOD - 1;
+        int fixed = i % DIFF_FIXED_PERIOD == 1;
+        if (fixed)
+            diff_fixed_case_random(&c, &state, signatures, i / DIFF_FIXED_PERIOD % diff_fixed_num_sets());
+        else
+            diff_case_random(&c, &state, signatures, verifier);
+        printf("\r[%d/%d]", i, cases);
+        fflush(stdout);
+
+        diff_divergence_t divergence;
+        if (fixed) {
+            long long *messages = malloc(sizeof(long long) * c.signatures);
+            for (long long n = 0; n < c.signatures; n++)
+                messages[n] = n;
+            fixed_signatures += diff_fixed_run(&c, messages, c.signatures, DIFF_FIXED_LANE, &divergence);
+            if (divergence.signature >= 0) {
+                printf("\nCase %d (fixed layer): ", i);
+                diff_print_case(&c);
+                printf("\n");
+                diff_print_divergence(&divergence, diff_lane_name(divergence.lane));
+                long long length = diff_fixed_minimize(&c, messages, divergence.signature + 1);
+                diff_fixed_run(&c, messages, length, DIFF_FIXED_LANE, &divergence);
+                printf("Reduced to %lld messages: ", length);
+                diff_print_divergence(&divergence, diff_lane_name(divergence.lane));
+                if (diff_fixed_write_reproducer(DIFF_REPRODUCER, &c, messages, length))
+                    printf("Reproducer written to %s (mumhors_diff replay %s)\n", DIFF_REPRODUCER, DIFF_REPRODUCER);
+                free(messages);
+                return 1;
+            }
+            free(messages);
+            continue;
+        }
+        if (verifier) {
+            verified_signatures += diff_verifier_run(&c, &divergence);
+            if (divergence.signature >= 0) {
+                printf("\nCase %d (signer and verifier): ", i);
+                diff_print_case(&c);
+                printf("\n");
+                diff_print_divergence(&divergence, bitmap_engines[divergence.lane]->name);
+                return 1;
+            }
+            continue;
+        }
+
+        int *sequence = malloc(sizeof(int) * c.k * c.signatures);
+        total_signatures += diff_run(&c, sequence, 0, 1, &divergence);
+        if (divergence.signature >= 0) {
+            printf("\nCase %d (%s indices): ", i, mode_names[c.mode]);
+            diff_print_case(&c);
+            printf("\n");
+            diff_print_divergence(&divergence, diff_lane_name(divergence.lane));
+            long long length = diff_minimize(&c, sequence, divergence.signature + 1);
+            diff_run(&c, sequence, length, 0, &divergence);
+            printf("Reduced to %lld signatures: ", length);
+            diff_print_divergence(&divergence, diff_lane_name(divergence.lane));
+            if (diff_write_reproducer(DIFF_REPRODUCER, &c, sequence, length))
+                printf("Reproducer written to %s (mumhors_diff replay %s)\n", DIFF_REPRODUCER, DIFF_REPRODUCER);
+            free(sequence);
+            return 1;
+        }
+        free(sequence);
+    }
+    printf("\r%d cases: %lld bitmap signatures on %d lanes, %lld signatures on %d signers and the verifier and %lld "
+           "on the fixed layer, no divergence\n", cases, total_signatures, DIFF_NUM_LANES, verified_signatures,
+           BITMAP_NUM_ENGINES, fixed_signatures);
+    return 0;
+}
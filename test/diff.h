@@ -0,0 +1,66 @@
+#ifndef MUMHORS_DIFF_H
+#define MUMHORS_DIFF_H
+
+#include <stdint.h>
+
+/* Differential driver (see diff.c). The fixed-layer lane is in diff_fixed.cpp, as mumhors_fixed.hpp is C++. */
+#define DIFF_L 256 /* HORS l parameter of the signatures */
+
+/// Hyperparameters and index sequence of a case
+typedef struct diff_case {
+    int t; /* HORS t parameter (window size and columns) */
+    int k; /* HORS k parameter */
+    long long r; /* Number of rows */
+    int rt; /* Row threshold */
+    int rt_min; /* Smallest row limit (rt for a fixed limit) */
+    int eviction_policy; /* Eviction policy (EVICTION_*) */
+    int eviction_param; /* Parameter of the eviction policy */
+    int run; /* Signatures of an extension run */
+    int mode; /* Index sequence (MODE_*) */
+    long long signatures; /* Signatures at most */
+    uint64_t seed; /* Seed of the indices (or of the seed and messages of a verifier or fixed case) */
+} diff_case_t;
+
+/// First difference between a lane and the reference
+typedef struct diff_divergence {
+    long long signature; /* Signature number (-1 if there is none) */
+    int lane; /* Lane number, or the engine of the signer in a verifier case */
+    char what[64]; /* What differs */
+    long long expected; /* Value of the reference */
+    long long actual; /* Value of the lane */
+} diff_divergence_t;
+
+/// Records a divergence if there is none yet
+/// \param divergence Pointer to the divergence
+/// \param signature Signature number
+/// \param lane Lane number
+/// \param what What differs
+/// \param expected Value of the reference
+/// \param actual Value of the lane
+/// \return 1 if the values differ
+int diff_check(diff_divergence_t *divergence, long long signature, int lane, const char *what, long long expected,
+               long long actual);
+
+/// Returns the number of parameter sets of the fixed layer (mumhors::fixed_parameter_sets)
+/// \return Number of sets
+int diff_fixed_num_sets(void);
+
+/// Fills the parameters of a case with a parameter set of the fixed layer, and the default settings of the C signer
+/// (fewest eviction, a fixed row limit and runs of one signature), the only ones the fixed layer implements
+/// \param c Pointer to the case
+/// \param set Set number (below diff_fixed_num_sets)
+void diff_fixed_case(diff_case_t *c, int set);
+
+/// Runs a fixed case: the C signer and the fixed signer sign the messages of the given numbers, and the C verifier
+/// and the fixed verifier check the signature of the C signer (corrupted for some message numbers). The signatures
+/// must be byte-identical, and both verifiers must give the status that the corruption calls for.
+/// \param c Pointer to the case
+/// \param messages Message numbers (a message is the hash of the seed of the case and its number)
+/// \param length Number of messages
+/// \param lane Lane number of the divergences
+/// \param divergence Pointer to the divergence which will be filled (its signature is the position in messages)
+/// \return Number of messages signed
+long long diff_fixed_run(const diff_case_t *c, const long long *messages, long long length, int lane,
+                         diff_divergence_t *divergence);
+
+#endif
@@ -0,0 +1,161 @@
+#include "mumhors_fixed.hpp"
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include "diff.h"
+}
+
+/* Fixed-layer lane of the differential driver: the C signer and verifier against the compile-time specialized ones
+ * of mumhors_fixed.hpp, for every set of mumhors::fixed_parameter_sets. The fixed layer has its own window, so its
+ * extension and eviction are checked against bitmap_window.h and mumhors_verifier_alloc_row_virtually. Every
+ * DIFF_FIXED_CORRUPT_PERIOD-th message number gets a corrupted signature: a flipped bit in one of its keys, which
+ * still consumes the keys of the indices, or a malformed stage or counter, which the verifiers reject before their
+ * window and which is followed by the genuine signature. The corruption only depends on the message number, so it
+ * stays the same when a sequence is cut down. */
+#define DIFF_FIXED_CORRUPT_PERIOD 5
+#define DIFF_FIXED_CORRUPT_KEY 0 /* A flipped bit in one of the keys */
+#define DIFF_FIXED_CORRUPT_STAGE 1 /* An unknown stage */
+#define DIFF_FIXED_CORRUPT_CTR 2 /* A counter outside the counter stage */
+#define DIFF_FIXED_CORRUPT_KINDS 3
+
+namespace {
+
+/// Parameters of the sets of mumhors::fixed_parameter_sets
+template<typename... Sets>
+constexpr auto fixed_set_table(std::tuple<Sets...> *) {
+    return std::array<std::array<int, 4>, sizeof...(Sets)>{{{Sets::t, Sets::k, Sets::l, Sets::rt}...}};
+}
+
+constexpr auto fixed_sets = fixed_set_table(static_cast<mumhors::fixed_parameter_sets *>(nullptr));
+
+/// Frees a public key matrix that no verifier took
+void free_pk_matrix(public_key_matrix_t *pk_matrix, int t) {
+    while (pk_matrix->head) {
+        public_key_t *pk_row = pk_matrix->head;
+        pk_matrix->head = pk_row->next;
+        for (int i = 0; i < t; i++)
+            std::free(pk_row->pks[i]);
+        std::free(pk_row->pks);
+        std::free(pk_row);
+    }
+}
+
+/// Verifies a signature with both verifiers and checks their status
+/// \return 1 if they diverge
+int verify_both(mumhors_verifier_t *verifier, mumhors::verifier_interface *fixed_verifier,
+                const mumhors_signature_t *signature, const unsigned char *message, long long n, int lane,
+                int expected, diff_divergence_t *divergence) {
+    int status = mumhors_verify_signature(verifier, signature, message, SHA256_OUTPUT_LEN);
+    int fixed_status = fixed_verifier->verify(*signature, message, SHA256_OUTPUT_LEN);
+    return diff_check(divergence, n, lane, "verification status", expected, status) ||
+           diff_check(divergence, n, lane, "fixed verification status", status, fixed_status);
+}
+
+} // namespace
+
+
+int diff_fixed_num_sets(void) {
+    return static_cast<int>(fixed_sets.size());
+}
+
+void diff_fixed_case(diff_case_t *c, int set) {
+    c->t = fixed_sets[set][0];
+    c->k = fixed_sets[set][1];
+    c->rt = c->rt_min = fixed_sets[set][3];
+    c->eviction_policy = EVICTION_FEWEST;
+    c->eviction_param = 0;
+    c->run = 1;
+}
+
+long long diff_fixed_run(const diff_case_t *c, const long long *messages, long long length, int lane,
+                         diff_divergence_t *divergence) {
+    const int k = c->k;
+    unsigned char seed[SHA256_OUTPUT_LEN];
+    blake2b_256(seed, reinterpret_cast<const unsigned char *>(&c->seed), sizeof(c->seed));
+    divergence->signature = -1;
+
+    /* The fixed verifier takes the ownership of its own public keys */
+    public_key_matrix_t pk_matrix, fixed_pk_matrix;
+    mumhors_pk_gen(&pk_matrix, seed, sizeof(seed), c->r, c->t);
+    mumhors_pk_gen(&fixed_pk_matrix, seed, sizeof(seed), c->r, c->t);
+    auto fixed_signer = mumhors::make_fixed_signer(c->t, k, DIFF_L, c->rt, seed, sizeof(seed), c->r,
+                                                   c->eviction_policy, c->eviction_param, c->rt_min, c->run);
+    auto fixed_verifier = mumhors::make_fixed_verifier(c->t, k, DIFF_L, c->rt, fixed_pk_matrix, c->r,
+                                                       c->eviction_policy, c->eviction_param, c->rt_min, c->run);
+    mumhors_signer_t signer;
+    mumhors_verifier_t verifier;
+    if (mumhors_init_signer(&signer, seed, sizeof(seed), c->t, k, DIFF_L, c->rt, c->r, nullptr) !=
+        MUMHORS_INIT_SUCCESS ||
+        mumhors_init_verifier(&verifier, pk_matrix, c->t, k, DIFF_L, c->r, c->t, c->rt, c->t) !=
+        MUMHORS_INIT_SUCCESS) {
+        printf("\nCannot allocate the signer and the verifier (rt=%d, t=%d)\n", c->rt, c->t);
+        exit(1);
+    }
+    mumhors_signer_set_eviction(&signer, c->eviction_policy, c->eviction_param);
+    mumhors_signer_set_row_limit(&signer, c->rt_min, ROW_LIMIT_DEFAULT_TARGET, ROW_LIMIT_DEFAULT_EPOCH);
+    mumhors_signer_set_extension_run(&signer, c->run);
+    mumhors_verifier_set_eviction(&verifier, c->eviction_policy, c->eviction_param);
+    mumhors_verifier_set_row_limit(&verifier, c->rt_min, ROW_LIMIT_DEFAULT_TARGET, ROW_LIMIT_DEFAULT_EPOCH);
+    mumhors_verifier_set_extension_run(&verifier, c->run);
+
+    long long n = 0;
+    if (diff_check(divergence, 0, lane, "fixed signer", 1, fixed_signer != nullptr) ||
+        diff_check(divergence, 0, lane, "fixed verifier", 1, fixed_verifier != nullptr)) {
+        /* The verifier owns the keys only once it is created */
+        if (!fixed_verifier)
+            free_pk_matrix(&fixed_pk_matrix, c->t);
+        length = 0;
+    }
+
+    std::vector<unsigned char> corrupted_keys(k * SHA256_OUTPUT_LEN);
+    unsigned char message[SHA256_OUTPUT_LEN], seed_number[SHA256_OUTPUT_LEN + sizeof(long long)];
+    std::memcpy(seed_number, seed, SHA256_OUTPUT_LEN);
+    for (int failed = 0; !failed && n < length; n++) {
+        std::memcpy(seed_number + SHA256_OUTPUT_LEN, &messages[n], sizeof(long long));
+        blake2b_256(message, seed_number, sizeof(seed_number));
+
+        int status = mumhors_sign_message(&signer, message, SHA256_OUTPUT_LEN);
+        int fixed_status = fixed_signer->sign(message, SHA256_OUTPUT_LEN);
+        const mumhors_signature_t &fixed_signature = fixed_signer->signature();
+        failed = diff_check(divergence, n, lane, "signing status", status, fixed_status) ||
+                 diff_check(divergence, n, lane, "signature stage", signer.signature.stage, fixed_signature.stage) ||
+                 diff_check(divergence, n, lane, "signature counter", signer.signature.ctr, fixed_signature.ctr) ||
+                 diff_check(divergence, n, lane, "signature bytes", 0,
+                            std::memcmp(signer.signature.signature, fixed_signature.signature,
+                                        k * SHA256_OUTPUT_LEN) != 0);
+        if (failed)
+            break;
+
+        /* The signature of a failed signing is complete, only the next ones have no window */
+        mumhors_signature_t corrupted = signer.signature;
+        if (messages[n] % DIFF_FIXED_CORRUPT_PERIOD != DIFF_FIXED_CORRUPT_PERIOD - 1) {
+            failed = verify_both(&verifier, fixed_verifier.get(), &signer.signature, message, n, lane,
+                                 VERIFY_SIGNATURE_VALID, divergence);
+        } else if (messages[n] / DIFF_FIXED_CORRUPT_PERIOD % DIFF_FIXED_CORRUPT_KINDS == DIFF_FIXED_CORRUPT_KEY) {
+            std::memcpy(corrupted_keys.data(), signer.signature.signature, k * SHA256_OUTPUT_LEN);
+            corrupted_keys[messages[n] % (k * SHA256_OUTPUT_LEN)] ^= 1 << (messages[n] % 8);
+            corrupted.signature = corrupted_keys.data();
+            failed = verify_both(&verifier, fixed_verifier.get(), &corrupted, message, n, lane,
+                                 VERIFY_SIGNATURE_INVALID, divergence);
+        } else {
+            if (messages[n] / DIFF_FIXED_CORRUPT_PERIOD % DIFF_FIXED_CORRUPT_KINDS == DIFF_FIXED_CORRUPT_STAGE) {
+                corrupted.stage = RS_STAGE_CTR + 1;
+            } else {
+                corrupted.stage = RS_STAGE_HASH;
+                corrupted.ctr |= 1;
+            }
+            failed = verify_both(&verifier, fixed_verifier.get(), &corrupted, message, n, lane,
+                                 VERIFY_SIGNATURE_INVALID, divergence) ||
+                     verify_both(&verifier, fixed_verifier.get(), &signer.signature, message, n, lane,
+                                 VERIFY_SIGNATURE_VALID, divergence);
+        }
+        failed = failed || status == SIGN_NO_MORE_ROW_FAILED;
+    }
+
+    mumhors_delete_signer(&signer);
+    mumhors_delete_verifier(&verifier);
+    return n;
+}
@@ -1,8 +1,10 @@
 #include "debug.h"
 #include "mumhors.h"
+#include "row_threshold.h"
 #include "hash.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/time.h>
 #include <assert.h>
 
@@ -10,9 +12,39 @@
 int main(int argc, char **argv) {
     if (argc < 8) {
         printf("|HELP|\n\tRun:\n");
-        printf("\t\t mumhors T K L R RT TESTS SEED_FILE\n");
+        printf("\t\t mumhors T K L R RT TESTS SEED_FILE [ENGINE] [EVICTION[:PARAM]] [RUN]\n");
+        printf("\tEngines:");
+        for (int i = 0; i < BITMAP_NUM_ENGINES; i++)
+            printf(" %s", bitmap_engines[i]->name);
+        printf(" (default: %s)\n", BITMAP_DEFAULT_ENGINE->name);
+        printf("\tEviction policies:");
+        for (int i = 0; i < EVICTION_NUM_POLICIES; i++)
+            printf(" %s", eviction_policy_names[i]);
+        printf(" (default: %s)\n", eviction_policy_names[EVICTION_FEWEST]);
+        printf("\tRT: a fixed row threshold, MIN-MAX for a limit adapting between MIN and MAX rows, or auto for the "
+               "autotuned threshold\n");
+        printf("\tRUN: signatures served by one window extension (default: 1, at most T/K)\n");
         exit(1);
     }
+    /* The bitmap engine of the signer */
+    const bitmap_engine_t *engine = BITMAP_DEFAULT_ENGINE;
+    if (argc > 8 && !(engine = bitmap_engine_find(argv[8]))) {
+        printf("Unknown bitmap engine: %s\n", argv[8]);
+        exit(1);
+    }
+    /* The eviction policy of the signer and the verifier, with its parameter after a colon */
+    int eviction_policy = EVICTION_FEWEST, eviction_param = 0;
+    if (argc > 9) {
+        char *param = strchr(argv[9], ':');
+        if (param) {
+            *param++ = '\0';
+            eviction_param = atoi(param);
+        }
+        if ((eviction_policy = eviction_policy_find(argv[9])) < 0) {
+            printf("Unknown eviction policy: %s\n", argv[9]);
+            exit(1);
+        }
+    }
     /*
      * Reading the seed
      */
@@ -28,9 +60,29 @@ int main(int argc, char **argv) {
     const int t = atoi(argv[1]);
     const int k = atoi(argv[2]);
     const int l = atoi(argv[3]);
-    const int r = atoi(argv[4]);
-    const int rt = atoi(argv[5]);
-    const int tests = atoi(argv[6]);
+    const long long r = atoll(argv[4]);
+    /* An adaptive row limit is given as its bounds, MIN-MAX, and the autotuned threshold as auto */
+    const char *rt_max = strchr(argv[5], '-');
+    int rt = atoi(rt_max ? rt_max + 1 : argv[5]);
+    int rt_min = atoi(argv[5]);
+    const long long tests = atoll(argv[6]);
+    const int extension_run = argc > 10 ? atoi(argv[10]) : 1;
+
+    /* The threshold is tuned once, with the engine, eviction policy and run of the signer, for both sides */
+    if (!strcmp(argv[5], "auto")) {
+        simulation_config_t config;
+        simulation_config_init(&config, t, k, r, 1);
+        config.engine = engine;
+        config.eviction_policy = eviction_policy;
+        config.eviction_param = eviction_param;
+        config.run = extension_run;
+        rt = rt_min = row_threshold_autotune(&config, ROW_THRESHOLD_DEFAULT_TARGET, NULL);
+        if (!rt) {
+            printf("Cannot allocate the bitmap of a row of %d columns\n", t);
+            exit(1);
+        }
+        printf("Autotuned row threshold: %d\n", rt);
+    }
 
     /*
      *
@@ -55,7 +107,7 @@ int main(int argc, char **argv) {
     printf("KEYGEN: %0.6f ms\n", keygen_time_ms);
 
     /* Average time to generate one public key (in microseconds) */
-    double total_pks = (double) rt * (double) t;
+    double total_pks = (double) r * (double) t;
     if (total_pks > 0) {
         double keygen_per_pk_us = keygen_time_s * 1.0e6 / total_pks;
         printf("KEYGEN per PK: %0.5f us (average)\n", keygen_per_pk_us);
@@ -69,13 +121,24 @@ int main(int argc, char **argv) {
      *  Signing and Verifying
      *
      */
-    /* Create and initialize the signer */
+    /* Create the signer and the verifier */
     mumhors_signer_t signer;
-    mumhors_init_signer(&signer, seed, seed_len, t, k, l, rt, r);
-
-    /* Create and initialize the verifier */
     mumhors_verifier_t verifier;
-    mumhors_init_verifier(&verifier, pk_matrix, t, k, l, r, t, rt, t);
+    if (mumhors_init_signer(&signer, seed, seed_len, t, k, l, rt, r, engine) != MUMHORS_INIT_SUCCESS ||
+        mumhors_init_verifier(&verifier, pk_matrix, t, k, l, r, t, rt, t) != MUMHORS_INIT_SUCCESS) {
+        printf("Cannot allocate a window of %d rows of %d keys for the signer and the verifier\n", rt, t);
+        exit(1);
+    }
+
+    /* Initialize the signer */
+    mumhors_signer_set_eviction(&signer, eviction_policy, eviction_param);
+    mumhors_signer_set_row_limit(&signer, rt_min, ROW_LIMIT_DEFAULT_TARGET, ROW_LIMIT_DEFAULT_EPOCH);
+    mumhors_signer_set_extension_run(&signer, extension_run);
+
+    /* Initialize the verifier */
+    mumhors_verifier_set_eviction(&verifier, eviction_policy, eviction_param);
+    mumhors_verifier_set_row_limit(&verifier, rt_min, ROW_LIMIT_DEFAULT_TARGET, ROW_LIMIT_DEFAULT_EPOCH);
+    mumhors_verifier_set_extension_run(&verifier, extension_run);
 
     /* Running the tests */
     debug("Running the test cases ...", DEBUG_INF);
@@ -85,10 +148,10 @@ int main(int argc, char **argv) {
     blake2b_256(message, seed, seed_len);
 
     /* Count number of messages that the signature was rejected for any reason (message/signature corruption)  */
-    int cnt_rejected_message_signatures = 0;
+    long long cnt_rejected_message_signatures = 0;
 
-    for (int message_index = 0; message_index < tests; message_index++) {
-        printf("\r[%d/%d]", message_index, tests);
+    for (long long message_index = 0; message_index < tests; message_index++) {
+        printf("\r[%lld/%lld]", message_index, tests);
         fflush(stdout);
 
         if (mumhors_sign_message(&signer, message, SHA256_OUTPUT_LEN) == SIGN_NO_MORE_ROW_FAILED) {
@@ -108,11 +171,29 @@ int main(int argc, char **argv) {
 
 
     printf("\n================ MUM-HORS Report ================\n");
-    printf("Accepted signatures: %d/%d (%d rejected)\n", tests - cnt_rejected_message_signatures, tests, cnt_rejected_message_signatures);
+    printf("Accepted signatures: %lld/%lld (%lld rejected)\n", tests - cnt_rejected_message_signatures, tests, cnt_rejected_message_signatures);
+    printf("Eviction (%s): signer discarded %lld keys in %lld rows, verifier %lld keys in %lld rows\n",
+           eviction_policy_names[eviction_policy], signer.bm.discarded_bits, signer.bm.discarded_rows,
+           verifier.discarded_pks, verifier.discarded_rows);
+    printf("Row limit: signer %d, verifier %d (%d-%d rows)\n", signer.bm.row_limit.limit, verifier.row_limit.limit,
+           rt_min, rt);
+    mumhors_capacity_t signer_capacity, verifier_capacity;
+    mumhors_signer_capacity(&signer, &signer_capacity);
+    mumhors_verifier_capacity(&verifier, &verifier_capacity);
+    printf("Capacity: signer %lld signatures, %lld keys in the window, %lld unallocated, about %lld signatures left; "
+           "verifier %lld signatures, about %lld left\n", signer_capacity.signatures, signer_capacity.window_keys,
+           signer_capacity.unallocated_keys, signer_capacity.remaining_signatures, verifier_capacity.signatures,
+           verifier_capacity.remaining_signatures);
 
     #ifdef JOURNAL
         mumhors_report_time(tests);
         bitmap_report(&signer.bm);
+
+        mumhors_rs_stats_t rs_stats;
+        mumhors_signer_rs_stats(&signer, &rs_stats);
+        mumhors_report_rs_stats("Signer", &rs_stats);
+        mumhors_verifier_rs_stats(&verifier, &rs_stats);
+        mumhors_report_rs_stats("Verifier", &rs_stats);
     #endif
 
     mumhors_delete_verifier(&verifier);
@@ -0,0 +1,146 @@
+#include "simulation.h"
+#include "row_threshold.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+
+int main(int argc, char **argv) {
+    if (argc < 5) {
+        printf("|HELP|\n\tRun:\n");
+        printf("\t\t mumhors_sim T K R RT [TRIALS] [THREADS] [ENGINE] [EVICTION[:PARAM]] [RUN] [SIGNATURES]\n");
+        printf("\tEngines:");
+        for (int i = 0; i < BITMAP_NUM_ENGINES; i++)
+            printf(" %s", bitmap_engines[i]->name);
+        printf(" (default: %s)\n", BITMAP_DEFAULT_ENGINE->name);
+        printf("\tEviction policies:");
+        for (int i = 0; i < EVICTION_NUM_POLICIES; i++)
+            printf(" %s", eviction_policy_names[i]);
+        printf(" (default: %s)\n", eviction_policy_names[EVICTION_FEWEST]);
+        printf("\tRT: a fixed row threshold, MIN-MAX for a limit adapting between MIN and MAX rows, or auto for the "
+               "autotuned threshold\n");
+        printf("\tRUN: signatures served by one window extension (default: 1, at most T/K)\n");
+        printf("\tSIGNATURES: signatures after which a trial stops (default: 0, until the rows run out)\n");
+        exit(1);
+    }
+    const int t = atoi(argv[1]);
+    const int k = atoi(argv[2]);
+    const long long r = atoll(argv[3]);
+    const int trials = argc > 5 ? atoi(argv[5]) : 1;
+    const int threads = argc > 6 ? atoi(argv[6]) : 1;
+
+    /* An adaptive row limit is given as its bounds, MIN-MAX, and the autotuned threshold as auto */
+    const char *rt_max = strchr(argv[4], '-');
+    const int rt_auto = !strcmp(argv[4], "auto");
+    int rt = atoi(rt_max ? rt_max + 1 : argv[4]);
+    int rt_min = atoi(argv[4]);
+
+    simulation_config_t config;
+    simulation_config_init(&config, t, k, r, rt);
+    config.rt_min = rt_min;
+    config.engine = BITMAP_DEFAULT_ENGINE;
+    if (argc > 7 && !(config.engine = bitmap_engine_find(argv[7]))) {
+        printf("Unknown bitmap engine: %s\n", argv[7]);
+        exit(1);
+    }
+    if (argc > 8) {
+        char *param = strchr(argv[8], ':');
+        if (param) {
+            *param++ = '\0';
+            config.eviction_param = atoi(param);
+        }
+        if ((config.eviction_policy = eviction_policy_find(argv[8])) < 0) {
+            printf("Unknown eviction policy: %s\n", argv[8]);
+            exit(1);
+        }
+    }
+    config.run = argc > 9 ? atoi(argv[9]) : 1;
+    config.max_signatures = argc > 10 ? atoll(argv[10]) : 0;
+
+    /* The threshold is tuned with the engine, eviction policy and run of the simulation */
+    if (rt_auto && t % 8 == 0 && k >= 1 && k < t && r >= 1 && config.run >= 1) {
+        row_threshold_tuning_t tuning;
+        config.rt = config.rt_min = rt = row_threshold_autotune(&config, ROW_THRESHOLD_DEFAULT_TARGET, &tuning);
+        if (!rt) {
+            printf("Cannot allocate the bitmap of a row of %d columns\n", t);
+            exit(1);
+        }
+        printf("================ Row threshold (t=%d k=%d r=%lld, target %d per mille) ================\n", t, k, r,
+               ROW_THRESHOLD_DEFAULT_TARGET);
+        printf("Analytical threshold: %d (root %.3f, alpha %.2f)\n", tuning.analytical, tuning.solution,
+               ROW_THRESHOLD_DEFAULT_ALPHA);
+        printf("%-6s %16s %12s %14s %8s\n", "RT", "Discarded bits", "Key usage", "ns/signature", "Cost");
+        for (int i = 0; i < tuning.candidates; i++)
+            printf("%-6d %15.2f%% %11.2f%% %14.1f %8.3f\n", tuning.candidate[i].rt, tuning.candidate[i].discarded / 10,
+                   tuning.candidate[i].key_usage / 10, tuning.candidate[i].ns_per_signature, tuning.candidate[i].cost);
+        printf("Autotuned threshold: %d\n", tuning.rt);
+    }
+    if (trials < 1 || config.rt_min < 1 || config.rt_min > rt || rt > r || t % 8 || k < 1 || k > t ||
+        config.run < 1) {
+        printf("Invalid parameters\n");
+        exit(1);
+    }
+
+    /*
+     *
+     *  Simulation
+     *
+     */
+    printf("================ Simulation (t=%d k=%d r=%lld rt=%d-%d, %s engine, %s eviction, run %d) ================\n",
+           t, k, r, config.rt_min, rt, config.engine->name, eviction_policy_names[config.eviction_policy],
+           config.run);
+    simulation_result_t *results = malloc(sizeof(simulation_result_t) * trials);
+    struct timeval start_time, end_time;
+    gettimeofday(&start_time, NULL);
+    simulation_run_trials(&config, trials, threads, results);
+    gettimeofday(&end_time, NULL);
+    double seconds = (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_usec - start_time.tv_usec) / 1.0e6;
+
+    /*
+     *
+     *  Report
+     *
+     */
+    printf("%-6s %14s %10s %12s %12s %16s %10s %10s %10s\n", "Trial", "Signatures", "Exhausted", "Used rows",
+           "Evicted rows", "Discarded bits", "Key usage", "Mean rows", "Seconds");
+    long long total_signatures = 0, least_signatures = 0, most_signatures = 0;
+    double total_usage = 0, total_discarded = 0;
+    int completed = 0;
+    for (int i = 0; i < trials; i++) {
+        const simulation_result_t *result = &results[i];
+        if (result->failed) {
+            printf("%-6d %14s\n", i, "failed");
+            continue;
+        }
+        double usage = 100.0 * result->signatures * k / ((double) r * t);
+        double discarded = 100.0 * result->discarded_bits / ((double) r * t);
+        printf("%-6d %14lld %10s %12lld %12lld %15.2f%% %9.2f%% %10.2f %10.2f\n", i, result->signatures,
+               result->exhausted ? "yes" : "no", result->used_rows, result->discarded_rows, discarded, usage,
+               (double) result->active_rows / result->signatures, result->seconds);
+        total_signatures += result->signatures;
+        total_usage += usage;
+        total_discarded += discarded;
+        if (!completed || result->signatures < least_signatures)
+            least_signatures = result->signatures;
+        if (!completed || result->signatures > most_signatures)
+            most_signatures = result->signatures;
+        completed++;
+    }
+    if (completed < trials)
+        printf("%d of %d trials failed: the bitmap of %d rows of %d columns could not be allocated\n",
+               trials - completed, trials, rt, t);
+    if (!completed) {
+        free(results);
+        return 1;
+    }
+    printf("Signatures per trial: %.1f on average (%lld-%lld), key usage %.2f%%, discarded bits %.2f%%\n",
+           (double) total_signatures / completed, least_signatures, most_signatures, total_usage / completed,
+           total_discarded / completed);
+    printf("Simulated %lld signatures in %.2f s on %d threads (%.2f M signatures/s)\n", total_signatures, seconds,
+           threads < trials ? threads : trials, total_signatures / seconds / 1.0e6);
+    printf("Discarded bits and key usage are shares of the r * t private keys\n");
+
+    free(results);
+    return completed < trials;
+}